@@ -0,0 +1,156 @@
+/*
+ * Host check for the continuous ADC demux and filters
+ * Feeds synthetic TYPE2 DMA frames through AdcDemux: routing, dropped
+ * results, oversampling noise reduction, smoothing, and demux throughput.
+ *
+ * Build: g++ -O2 -std=c++17 -Iinclude bench/adc_frames.cpp -o adc_frames
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "AdcFrames.h"
+#include "check.h"
+
+static void put(std::vector<uint8_t>& buf, uint32_t word) {
+  uint8_t b[4];
+  memcpy(b, &word, 4);
+  buf.insert(buf.end(), b, b + 4);
+}
+
+// Deterministic noise in [-amp, amp]
+static int noise(uint32_t& state, int amp) {
+  state = state * 1664525u + 1013904223u;
+  return (int)(state >> 16) % (2 * amp + 1) - amp;
+}
+
+// Interleaved pattern over four channels, constant inputs
+static void checkRouting() {
+  AdcCalibration cal;
+  AdcDemux demux;
+  const uint8_t channels[] = {0, 3, 4, 9};
+  const uint16_t raw[] = {0, 1000, 2048, 4095};
+  demux.configure(channels, 4, 8, 0, &cal);
+
+  std::vector<uint8_t> buf;
+  for (int round = 0; round < 8; round++) {
+    for (int i = 0; i < 4; i++) put(buf, adcEncodeResult(0, channels[i], raw[i]));
+  }
+  put(buf, adcEncodeResult(1, 3, 123));  // ADC2 result
+  put(buf, adcEncodeResult(0, 5, 123));  // Channel not in the pattern
+  buf.push_back(0xAA);                   // Partial trailing result
+
+  size_t used = demux.feed(buf.data(), buf.size());
+  check(used == 32, "routing: wrong number of results used");
+  check(demux.foreignCount() == 2, "routing: foreign results not counted");
+  for (int i = 0; i < 4; i++) {
+    float mv = -1;
+    check(demux.latest(i, mv), "routing: no value after a full block");
+    check(mv == cal.toMv(raw[i]), "routing: value does not match the calibration table");
+    check(demux.blockCount(i) == 1, "routing: wrong block count");
+  }
+  check(demux.slotForChannel(4) == 2 && demux.slotForChannel(5) == -1, "routing: slot lookup");
+
+  float mv;
+  AdcDemux empty;
+  empty.configure(channels, 4, 8, 0, &cal);
+  put(buf, 0);
+  empty.feed(buf.data(), 7 * 4);  // Less than a block per channel
+  check(!empty.latest(0, mv), "routing: value published before a full block");
+}
+
+// Averaging 64 conversions cuts uniform noise by about 8x
+static void checkOversampling() {
+  AdcCalibration cal;
+  cal.buildLinear(4095);  // 1 mV per count keeps the numbers readable
+  const uint8_t channel = 2;
+  const int level = 2000;
+  const int amp = 100;
+
+  double rawVar = 0;
+  double avgVar = 0;
+  int blocks = 0;
+  uint32_t state = 1;
+  AdcDemux demux;
+  demux.configure(&channel, 1, 64, 0, &cal);
+
+  std::vector<uint8_t> buf;
+  for (int b = 0; b < 500; b++) {
+    buf.clear();
+    for (int i = 0; i < 64; i++) {
+      int n = noise(state, amp);
+      rawVar += n * n;
+      put(buf, adcEncodeResult(0, channel, level + n));
+    }
+    demux.feed(buf.data(), buf.size());
+    float mv;
+    if (demux.latest(0, mv)) {
+      avgVar += (mv - level) * (mv - level);
+      blocks++;
+    }
+  }
+  double rawSd = sqrt(rawVar / (500.0 * 64));
+  double avgSd = sqrt(avgVar / blocks);
+  check(blocks == 500, "oversampling: one value per 64 conversions");
+  check(avgSd < rawSd / 5, "oversampling: noise not reduced");
+  printf("oversample 64: raw sd %.1f mV, filtered sd %.2f mV\n", rawSd, avgSd);
+}
+
+// First block seeds the filter, a step then converges geometrically
+static void checkSmoothing() {
+  AdcCalibration cal;
+  cal.buildLinear(4095);
+  const uint8_t channel = 0;
+  AdcDemux demux;
+  demux.configure(&channel, 1, 1, 2, &cal);  // Weight 1/4
+
+  std::vector<uint8_t> buf;
+  put(buf, adcEncodeResult(0, channel, 1000));
+  demux.feed(buf.data(), buf.size());
+  float mv = 0;
+  demux.latest(0, mv);
+  check(mv == 1000, "smoothing: first value should not be filtered");
+
+  buf.clear();
+  put(buf, adcEncodeResult(0, channel, 2000));
+  demux.feed(buf.data(), buf.size());
+  demux.latest(0, mv);
+  check(fabsf(mv - 1250) < 0.01f, "smoothing: step not weighted by 1/4");
+
+  for (int i = 0; i < 40; i++) demux.feed(buf.data(), buf.size());
+  demux.latest(0, mv);
+  check(fabsf(mv - 2000) < 1, "smoothing: did not converge");
+}
+
+// Demux cost per conversion for a full 10-channel pattern
+static void benchFeed() {
+  AdcCalibration cal;
+  AdcDemux demux;
+  uint8_t channels[ADC_MAX_CHANNELS];
+  for (uint8_t i = 0; i < ADC_MAX_CHANNELS; i++) channels[i] = i;
+  demux.configure(channels, ADC_MAX_CHANNELS, 16, 3, &cal);
+
+  std::vector<uint8_t> frame;
+  uint32_t state = 7;
+  for (int i = 0; i < 64; i++) {
+    put(frame, adcEncodeResult(0, i % ADC_MAX_CHANNELS, 2000 + noise(state, 50)));
+  }
+
+  const int frames = 200000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) demux.feed(frame.data(), frame.size());
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  check(demux.conversionCount() == (uint32_t)frames * 64, "bench: conversions lost");
+  printf("demux: %u conversions in %.3f s (%.1f M/s, %.1f ns each)\n", demux.conversionCount(),
+         s, demux.conversionCount() / s / 1e6, s * 1e9 / demux.conversionCount());
+}
+
+int main() {
+  checkRouting();
+  checkOversampling();
+  checkSmoothing();
+  benchFeed();
+
+  return checkResult();
+}
@@ -0,0 +1,328 @@
+/*
+ * Host benchmark: compile-time board profile against the runtime channel table
+ * Builds ConfigLib with a 29-channel board profile (the fixed part of
+ * scan_bench's 30-channel layout plus two edge counters) and three runtime
+ * I2C channels, checks that the generated scan fills the same frame as the
+ * channel table with as many SPI transactions, then times scanAll() both
+ * ways with read statistics off and on, under the "none" and "typical"
+ * latency profiles. Prints JSON Lines like scan_bench and exits 1 if the
+ * two scans differ.
+ * RAM is the data each scan path reads for the fixed channels. For flash,
+ * compare `size` of the firmware built with and without -DBOARD_PROFILE.
+ *
+ * Build: g++ -O2 -std=gnu++17 -pthread -Isim -Iinclude -Isrc -I<ArduinoJson>/src
+ *        -DARDUINOJSON_ENABLE_ARDUINO_STRING=1 -DARDUINOJSON_ENABLE_ARDUINO_STREAM=1
+ *        -DARDUINOJSON_ENABLE_ARDUINO_PRINT=1 bench/board_profile_bench.cpp
+ *        sim/SimHardware.cpp -o board_profile_bench
+ * Usage: board_profile_bench [--ms 200] [--sd DIR] >> bench.jsonl
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "BoardProfile.h"
+
+// Pins as in scan_bench: SD (10-13) and I2C (21, 22) skipped, DS18B20s on 37 and 38
+typedef BoardProfile<DigitalPin<1, 1>, DigitalPin<2, 2>, DigitalPin<3, 3>,
+                     AnalogPin<4, 4>, AnalogPin<5, 5>, AnalogPin<6, 6>,
+                     SpiPin<7, 7>, OneWirePin<8, 38>, OneWirePin<9, 37>,
+                     DigitalPin<10, 14>, DigitalPin<11, 15>, DigitalPin<12, 16>,
+                     AnalogPin<13, 17>, AnalogPin<14, 18>, AnalogPin<15, 19>,
+                     SpiPin<16, 20>, OneWirePin<17, 37, 1>, OneWirePin<18, 38, 1>,
+                     DigitalPin<19, 23>, DigitalPin<20, 24>, DigitalPin<21, 25>,
+                     AnalogPin<22, 26>, AnalogPin<23, 27>, AnalogPin<24, 28>,
+                     SpiPin<25, 29>, OneWirePin<26, 38, 2>, OneWirePin<27, 37, 2>,
+                     EdgePin<28, 30>, EdgePin<29, 31, CH_FREQUENCY>> BenchProfile;
+
+#define BOARD_PROFILE BenchProfile
+#include "ConfigLib.ino"
+
+// ========== HELPERS ==========
+
+static uint32_t benchMs = 200;
+static int failures = 0;
+
+static uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t percentile(std::vector<uint64_t>& v, double p) {
+  if (v.empty()) return 0;
+  size_t i = (size_t)(p * (v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + i, v.end());
+  return v[i];
+}
+
+static double mean(const std::vector<uint64_t>& v) {
+  if (v.empty()) return 0;
+  double sum = 0;
+  for (uint64_t x : v) sum += x;
+  return sum / v.size();
+}
+
+// One JSON object per output line
+class JsonLine {
+private:
+  std::string buf;
+
+  void key(const char* k) {
+    buf += buf.empty() ? "{\"" : ",\"";
+    buf += k;
+    buf += "\":";
+  }
+
+public:
+  JsonLine& add(const char* k, const char* v) {
+    key(k);
+    buf += "\"";
+    buf += v;
+    buf += "\"";
+    return *this;
+  }
+
+  JsonLine& add(const char* k, double v) {
+    char num[32];
+    snprintf(num, sizeof(num), "%.6g", v);
+    key(k);
+    buf += num;
+    return *this;
+  }
+
+  void print() {
+    printf("%s}\n", buf.c_str());
+    fflush(stdout);
+  }
+};
+
+// ========== LAYOUT ==========
+
+// A simulated device behind every profile channel, plus three I2C channels
+static void buildChannels() {
+  Sim.reset();
+  const ProfileChannel* p = BenchProfile::channels();
+  for (size_t i = 0; i < BenchProfile::count(); i++) {
+    switch (p[i].type) {
+      case CH_DIGITAL:
+        Sim.setDigital(p[i].pin, i & 1);
+        break;
+      case CH_ANALOG:
+        Sim.setAnalog(p[i].pin, 100 * i);
+        break;
+      case CH_SPI: {
+        const uint8_t response[] = {(uint8_t)i};
+        Sim.addSpiDevice(p[i].pin, response, sizeof(response));
+        break;
+      }
+      case CH_ONEWIRE:
+        Sim.addDS18B20(p[i].pin, 20.0f + 0.5f * i);
+        break;
+      default:
+        break;
+    }
+  }
+
+  std::vector<I2CChannel>& i2c = config.getI2CChannels();
+  i2c.clear();
+  for (int i = 0; i < 3; i++) {
+    uint8_t address = 0x08 + i;
+    const uint8_t reading[] = {0, (uint8_t)i};
+    Sim.addI2CDevice(address);
+    Sim.setI2CRegisters(address, 0x00, reading, sizeof(reading));
+    I2CChannel ic = I2CChannel();  // Zero rate and filter settings, no driver
+    ic.channel = MAX_FIXED_CHANNELS + 1 + i;
+    ic.id = i;
+    ic.address = address;
+    ic.active = true;
+    ic.reg = 0x00;
+    ic.length = 2;
+    i2c.push_back(ic);
+  }
+  config.rebuildChannelTable();
+}
+
+// Scan until every DS18B20 has a first conversion, so both paths read the same values
+static void warmUp(ScanFrame& frame) {
+  SimLatency saved = Sim.getLatency();
+  Sim.setLatency(SimLatency::none());
+  uint32_t start = millis();
+  bool ready = false;
+  while (!ready && millis() - start < 2000) {
+    config.scanAll(frame);
+    ready = true;
+    for (size_t i = 0; i < frame.count; i++) {
+      if (frame.status[i] == SAMPLE_NOT_READY) ready = false;
+    }
+    delay(5);
+  }
+  Sim.setLatency(saved);
+}
+
+// ========== BENCHMARKS ==========
+
+// The generated scan must write exactly what the channel table scan writes
+static void checkFrames() {
+  ScanFrame table;
+  ScanFrame profile;
+  table.reserve(config.scanSize());
+  profile.reserve(config.scanSize());
+
+  config.useBoardProfile(false);
+  uint32_t tx0 = config.getSpiTransactionCount();
+  config.scanAll(table);
+  uint32_t tableTx = config.getSpiTransactionCount() - tx0;
+  config.useBoardProfile(true);
+  bool active = config.boardProfileActive();
+  tx0 = config.getSpiTransactionCount();
+  config.scanAll(profile);
+  uint32_t profileTx = config.getSpiTransactionCount() - tx0;
+
+  bool same = active && table.count == profile.count;
+  for (size_t i = 0; same && i < table.count; i++) {
+    same = table.channel[i] == profile.channel[i] && table.status[i] == profile.status[i] &&
+           table.value[i] == profile.value[i] && table.sub[i] == profile.sub[i];
+  }
+
+  // A fixed channel changed at runtime hands the scan back to the table
+  updateChannel(2, "ANALOG");
+  bool fallback = !config.boardProfileActive();
+  updateChannel(2, "DIGITAL");
+  bool restored = config.boardProfileActive();
+
+  // Both paths read SPI in one batch, sharing transactions between channels
+  bool spiBatched = tableTx == profileTx;
+
+  if (!same || !fallback || !restored || !spiBatched) failures++;
+  JsonLine()
+      .add("bench", "profile_match")
+      .add("samples", profile.count)
+      .add("profile_active", active)
+      .add("frames_match", same)
+      .add("table_spi_transactions", tableTx)
+      .add("profile_spi_transactions", profileTx)
+      .add("fallback_on_change", fallback)
+      .add("restored", restored)
+      .print();
+}
+
+// Scans for ms milliseconds, appending each scan's time
+static void timeScans(ScanFrame& frame, std::vector<uint64_t>& samples, uint32_t ms) {
+  uint64_t end = nowNs() + ms * 1000000ULL;
+  while (nowNs() < end && samples.size() < samples.capacity()) {
+    uint64_t t0 = nowNs();
+    config.scanAll(frame);
+    samples.push_back(nowNs() - t0);
+  }
+}
+
+// Alternating blocks of both paths, so drift in host speed hits both alike
+static void benchScan(const char* latency, bool stats) {
+  const int blocks = 10;
+  ScanFrame frame;
+  frame.reserve(config.scanSize());
+  setReadStatsEnabled(stats);
+  std::vector<uint64_t> table;
+  std::vector<uint64_t> profile;
+  table.reserve(1 << 18);
+  profile.reserve(1 << 18);
+
+  uint32_t blockMs = std::max<uint32_t>(1, benchMs / (2 * blocks));
+  for (int b = 0; b < blocks; b++) {
+    config.useBoardProfile(false);
+    timeScans(frame, table, blockMs);
+    config.useBoardProfile(true);
+    timeScans(frame, profile, blockMs);
+  }
+  setReadStatsEnabled(true);
+
+  double tableP50 = percentile(table, 0.50);
+  double profileP50 = percentile(profile, 0.50);
+  JsonLine()
+      .add("bench", "profile_scan")
+      .add("profile", latency)
+      .add("read_stats", stats ? "on" : "off")
+      .add("fixed_channels", BenchProfile::count())
+      .add("samples", frame.count)
+      .add("table_scans", table.size())
+      .add("table_p50_ns", tableP50)
+      .add("table_mean_ns", mean(table))
+      .add("table_p99_ns", percentile(table, 0.99))
+      .add("profile_scans", profile.size())
+      .add("profile_p50_ns", profileP50)
+      .add("profile_mean_ns", mean(profile))
+      .add("profile_p99_ns", percentile(profile, 0.99))
+      .add("saved_pct", tableP50 > 0 ? 100.0 * (tableP50 - profileP50) / tableP50 : 0.0)
+      .print();
+}
+
+// Bytes each path reads per scan to find and read the fixed channels
+static void reportFootprint() {
+  size_t n = BenchProfile::count();
+  size_t strings = 0;
+  for (const auto& ch : config.getFixedChannels()) strings += ch.mode.length() + 1;
+  size_t planBytes = n * (sizeof(int16_t) + sizeof(ChannelSlot));
+  size_t fixedBytes = config.getFixedChannels().capacity() * sizeof(FixedChannel);
+
+  JsonLine()
+      .add("bench", "profile_footprint")
+      .add("fixed_channels", n)
+      .add("table_plan_ram_bytes", planBytes)
+      .add("table_fixed_channel_ram_bytes", fixedBytes)
+      .add("table_mode_string_bytes", strings)
+      .add("profile_scan_ram_bytes", 0.0)
+      .add("profile_table_flash_bytes", n * sizeof(ProfileChannel))
+      .print();
+}
+
+// ========== MAIN ==========
+
+int main(int argc, char** argv) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    if (arg == "--ms") {
+      benchMs = std::max(1, atoi(argv[i + 1]));
+    } else if (arg == "--sd") {
+      Sim.setSdRoot(argv[i + 1]);
+    } else {
+      fprintf(stderr, "usage: %s [--ms N] [--sd DIR]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  Serial.setOutput(nullptr);  // Keep stdout machine-readable
+  if (!config.begin()) {
+    fprintf(stderr, "SD root %s not usable\n", Sim.getSdRoot().c_str());
+    return 1;
+  }
+  config.beginBatch();  // Channel changes below stay off the SD card
+
+  JsonLine()
+      .add("bench", "meta")
+      .add("suite", "board_profile_bench")
+      .add("format", 1)
+      .add("bench_ms", benchMs)
+      .print();
+
+  buildChannels();
+  ScanFrame frame;
+  frame.reserve(config.scanSize());
+  warmUp(frame);
+  checkFrames();
+  reportFootprint();
+
+  const char* names[] = {"none", "typical"};
+  const SimLatency latencies[] = {SimLatency::none(), SimLatency::typical()};
+  for (int p = 0; p < 2; p++) {
+    Sim.setLatency(latencies[p]);
+    benchScan(names[p], false);
+    benchScan(names[p], true);
+  }
+  Sim.setLatency(SimLatency::none());
+
+  if (failures) {
+    fprintf(stderr, "generated scan differs from the channel table scan\n");
+    return 1;
+  }
+  return 0;
+}
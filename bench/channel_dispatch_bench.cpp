@@ -0,0 +1,164 @@
+/*
+ * Host microbenchmark: per-read channel dispatch cost
+ * Compares the old getChannelMode()/getChannelPin() string lookup chain
+ * against the compiled ChannelTable used by readChannel().
+ *
+ * Build: g++ -O2 -std=c++17 -Iinclude bench/channel_dispatch_bench.cpp -o dispatch_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "ChannelTable.h"
+
+// Heap-backed string, like Arduino String (no small-string optimization)
+struct HeapString {
+  char* buf;
+  HeapString() : buf(strdup("")) {}
+  HeapString(const char* s) : buf(strdup(s)) {}
+  HeapString(const HeapString& o) : buf(strdup(o.buf)) {}
+  HeapString& operator=(const HeapString& o) {
+    if (this != &o) {
+      free(buf);
+      buf = strdup(o.buf);
+    }
+    return *this;
+  }
+  ~HeapString() { free(buf); }
+  bool operator==(const char* s) const { return strcmp(buf, s) == 0; }
+};
+
+struct FixedChannel { int channel; int pin; HeapString mode; bool active; };
+struct I2CChannel { int channel; int id; uint8_t address; bool active; };
+
+static std::vector<FixedChannel> fixedChannels;
+static std::vector<I2CChannel> i2cChannels;
+static ChannelTable table;
+
+// ========== Old lookup path ==========
+
+static HeapString legacyMode(int channel) {
+  for (const auto& ch : fixedChannels) {
+    if (ch.channel == channel && ch.active) return ch.mode;
+  }
+  for (const auto& ch : i2cChannels) {
+    if (ch.channel == channel && ch.active) return HeapString("I2C");
+  }
+  return HeapString("NONE");
+}
+
+static int legacyPin(int channel) {
+  for (const auto& ch : fixedChannels) {
+    if (ch.channel == channel && ch.active) return ch.pin;
+  }
+  return -1;
+}
+
+static uint8_t legacyAddress(int channel) {
+  for (const auto& ch : i2cChannels) {
+    if (ch.channel == channel && ch.active) return ch.address;
+  }
+  return 0;
+}
+
+static int legacyResolve(int channel) {
+  HeapString mode = legacyMode(channel);
+  if (mode == "NONE") return -1;
+  if (mode == "DIGITAL") return legacyPin(channel);
+  if (mode == "ANALOG") return legacyPin(channel) + 1000;
+  if (mode == "ONEWIRE") return legacyPin(channel) + 2000;
+  if (mode == "SPI") return legacyPin(channel) + 3000;
+  if (mode == "I2C") return legacyAddress(channel) + 4000;
+  return -1;
+}
+
+// ========== Table lookup path ==========
+
+static int tableResolve(int channel) {
+  const ChannelSlot* slot = table.find(channel);
+  if (!slot) return -1;
+  switch (slot->type) {
+    case CH_DIGITAL: return slot->pin;
+    case CH_ANALOG:  return slot->pin + 1000;
+    case CH_ONEWIRE: return slot->pin + 2000;
+    case CH_SPI:     return slot->pin + 3000;
+    case CH_I2C:     return slot->address + 4000;
+    default:         return -1;
+  }
+}
+
+template <typename F>
+static double nsPerRead(F resolve, const std::vector<int>& channels, int rounds) {
+  volatile int sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (int ch : channels) sink = sink + resolve(ch);
+  }
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  return ns / ((double)rounds * channels.size());
+}
+
+int main() {
+  static const char* modes[] = {"DIGITAL", "ANALOG", "ONEWIRE", "SPI"};
+
+  // 30 fixed channels plus 8 I2C devices, like a fully populated board
+  for (int ch = 1; ch <= 30; ch++) {
+    FixedChannel fc;
+    fc.channel = ch;
+    fc.pin = ch + 1;
+    fc.mode = HeapString(modes[ch % 4]);
+    fc.active = true;
+    fixedChannels.push_back(fc);
+  }
+  for (int i = 0; i < 8; i++) {
+    I2CChannel ic;
+    ic.channel = 31 + i;
+    ic.id = i;
+    ic.address = 0x40 + i;
+    ic.active = true;
+    i2cChannels.push_back(ic);
+  }
+
+  int maxChannel = 38;
+  table.reset(maxChannel);
+  for (size_t i = 0; i < fixedChannels.size(); i++) {
+    const FixedChannel& ch = fixedChannels[i];
+    ChannelSlot slot = {};
+    slot.type = channelTypeFromMode(ch.mode.buf);
+    slot.pin = ch.pin;
+    slot.index = i;
+    table.assign(ch.channel, slot);
+  }
+  for (size_t i = 0; i < i2cChannels.size(); i++) {
+    const I2CChannel& ch = i2cChannels[i];
+    ChannelSlot slot = {};
+    slot.type = CH_I2C;
+    slot.address = ch.address;
+    slot.pin = -1;
+    slot.index = i;
+    table.assign(ch.channel, slot);
+  }
+
+  std::vector<int> channels;
+  for (int ch = 1; ch <= maxChannel; ch++) channels.push_back(ch);
+
+  for (int ch : channels) {
+    if (legacyResolve(ch) != tableResolve(ch)) {
+      printf("mismatch on channel %d\n", ch);
+      return 1;
+    }
+  }
+
+  const int rounds = 20000;
+  double legacy = nsPerRead(legacyResolve, channels, rounds);
+  double compiled = nsPerRead(tableResolve, channels, rounds);
+
+  printf("channels: %zu\n", channels.size());
+  printf("string lookup: %8.2f ns/read\n", legacy);
+  printf("channel table: %8.2f ns/read\n", compiled);
+  printf("speedup:       %8.1fx\n", legacy / compiled);
+  return 0;
+}
@@ -0,0 +1,197 @@
+/*
+ * Host check for the streaming statistics and output filters
+ * Compares window statistics with a two-pass double reference, checks
+ * decimation, deadband and status-change behaviour, and measures how much
+ * output a slowly changing sensor produces and what a sample costs.
+ *
+ * Build: g++ -O2 -std=c++17 -Iinclude bench/channel_stats.cpp -o channel_stats
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include "ChannelStats.h"
+#include "check.h"
+
+// Deterministic noise in [-1, 1]
+static float noise(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return (int32_t)(state >> 8) / 8388608.0f - 1.0f;
+}
+
+struct Reference {
+  double mean;
+  double variance;
+  float min;
+  float max;
+};
+
+// Two-pass mean and sample variance in double
+static Reference reference(const std::vector<float>& x) {
+  Reference r = {0, 0, x[0], x[0]};
+  for (float v : x) {
+    r.mean += v;
+    r.min = std::min(r.min, v);
+    r.max = std::max(r.max, v);
+  }
+  r.mean /= x.size();
+  for (float v : x) r.variance += (v - r.mean) * (v - r.mean);
+  r.variance /= x.size() - 1;
+  return r;
+}
+
+// One window of data against the reference; returns the relative variance error
+static double compareWindow(const char* name, const std::vector<float>& x) {
+  RunningStats stats;
+  for (size_t i = 0; i < x.size(); i++) stats.add(x[i], i);
+  WindowSummary s = stats.summary();
+  Reference r = reference(x);
+
+  double meanErr = fabs(s.mean - r.mean);
+  double varErr = fabs(s.variance - r.variance) / r.variance;
+  char what[96];
+  snprintf(what, sizeof(what), "accuracy %s: mean off by %g", name, meanErr);
+  check(meanErr <= fabs(r.mean) * 1e-6 + 1e-6, what);
+  snprintf(what, sizeof(what), "accuracy %s: variance off by %g relative", name, varErr);
+  check(varErr < 1e-3, what);
+  check(s.min == r.min && s.max == r.max && s.count == x.size(), "accuracy: min/max/count");
+
+  // What a naive float sum-of-squares would have given
+  float sum = 0, sumSq = 0;
+  for (float v : x) {
+    sum += v;
+    sumSq += v * v;
+  }
+  float naiveVar = (sumSq - sum * sum / x.size()) / (x.size() - 1);
+  printf("%-22s mean %.6f (ref %.6f), var %.6g (ref %.6g, naive float %.6g)\n", name,
+         s.mean, r.mean, s.variance, r.variance, naiveVar);
+  return varErr;
+}
+
+static void checkAccuracy() {
+  uint32_t state = 1;
+  std::vector<float> x(10000);
+
+  for (auto& v : x) v = 0.5f * noise(state);
+  compareWindow("zero mean", x);
+
+  for (auto& v : x) v = 25.0f + 0.01f * noise(state);  // Temperature with fine noise
+  compareWindow("offset 25, sd ~0.006", x);
+
+  for (auto& v : x) v = 100000.0f + noise(state);  // Pressure in Pa
+  compareWindow("offset 1e5, sd ~0.6", x);
+
+  for (size_t i = 0; i < x.size(); i++) x[i] = 2000.0f + i * 0.1f;  // Ramp
+  compareWindow("ramp", x);
+}
+
+// Tumbling windows: each completed window only covers its own samples
+static void checkWindows() {
+  FilterSettings settings = {0, 100, 0, 0};
+  ChannelFilter f;
+  f.configure(settings);
+  for (int i = 0; i < 250; i++) f.accept(i < 100 ? 1.0f : (float)i, SAMPLE_OK, i);
+  const WindowSummary& w = f.lastWindow();
+  check(w.count == 100, "windows: wrong count");
+  check(w.min == 100 && w.max == 199 && fabsf(w.mean - 149.5f) < 1e-4f,
+        "windows: second window mixed with the first");
+  check(w.startUs == 100 && w.endUs == 199, "windows: window times");
+  check(f.currentWindow().count == 50, "windows: partial window");
+
+  f.accept(0, SAMPLE_NO_DEVICE, 250);
+  check(f.currentWindow().count == 50, "windows: failed read entered the statistics");
+}
+
+static void checkDecimation() {
+  FilterSettings settings = {10, 0, 0, 0};
+  ChannelFilter f;
+  f.configure(settings);
+  int passed = 0;
+  for (int i = 0; i < 1000; i++) passed += f.accept(i, SAMPLE_OK, i);
+  check(passed == 100, "decimation: not 1 in 10");
+}
+
+// Deadband plus status changes and the report interval
+static void checkDeadband() {
+  FilterSettings settings = {0, 0, 0.5f, 10};
+  ChannelFilter f;
+  f.configure(settings);
+  uint32_t t = 0;
+  check(f.accept(20.0f, SAMPLE_OK, t), "deadband: first sample dropped");
+  check(!f.accept(20.4f, SAMPLE_OK, t += 1000), "deadband: small change passed");
+  check(!f.accept(19.6f, SAMPLE_OK, t += 1000), "deadband: small change passed");
+  check(f.accept(20.5f, SAMPLE_OK, t += 1000), "deadband: change of a full deadband dropped");
+  check(!f.accept(20.9f, SAMPLE_OK, t += 1000), "deadband: measured from the wrong value");
+  check(f.accept(0, SAMPLE_NO_DEVICE, t += 1000), "deadband: failure dropped");
+  check(!f.accept(0, SAMPLE_NO_DEVICE, t += 1000), "deadband: repeated failure passed");
+  check(f.accept(20.5f, SAMPLE_OK, t += 1000), "deadband: recovery dropped");
+  check(f.accept(20.5f, SAMPLE_OK, t += 10000), "deadband: report interval ignored");
+
+  // Five hours used to overflow to ~14 minutes in microseconds; clamped to one hour
+  settings.reportIntervalMs = 5 * 3600000UL;
+  f.configure(settings);
+  t = 0;
+  f.accept(20.0f, SAMPLE_OK, t);
+  check(!f.accept(20.0f, SAMPLE_OK, t += 1800000000u), "deadband: long interval wrapped");
+  check(f.accept(20.0f, SAMPLE_OK, t += 1800000000u), "deadband: long interval not clamped");
+}
+
+// A slowly drifting sensor with steps: volume drops, every step still shows
+static void checkVolume() {
+  FilterSettings settings = {0, 600, 0.2f, 60000};
+  ChannelFilter f;
+  f.configure(settings);
+  uint32_t state = 3;
+  const int samples = 360000;  // One hour at 100 Hz
+  int passed = 0;
+  int steps = 0;
+  int stepsSeen = 0;
+  float level = 20.0f;
+  for (int i = 0; i < samples; i++) {
+    bool step = i % 36000 == 18000;
+    if (step) {
+      level += (steps++ % 2) ? -2.0f : 2.0f;
+    }
+    level += 0.00001f;  // ~3.6 C drift over the hour
+    uint32_t nowUs = i * 10000u;
+    bool out = f.accept(level + 0.02f * noise(state), SAMPLE_OK, nowUs);
+    passed += out;
+    if (step && out) stepsSeen++;
+  }
+  check(stepsSeen == steps, "volume: a step change was not reported when it happened");
+  check(passed * 100 < samples, "volume: less than a 100x reduction");
+  printf("volume: %d of %d samples passed (%.0fx fewer), %d/%d steps reported on time\n",
+         passed, samples, (double)samples / passed, stepsSeen, steps);
+}
+
+static void benchAccept() {
+  FilterSettings settings = {4, 1000, 0.1f, 1000};
+  ChannelFilter f;
+  f.configure(settings);
+  uint32_t state = 9;
+  std::vector<float> x(4096);
+  for (auto& v : x) v = 50.0f + noise(state);
+
+  const int rounds = 5000;
+  uint32_t passed = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < x.size(); i++) passed += f.accept(x[i], SAMPLE_OK, r * 4096 + i);
+  }
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double n = (double)rounds * x.size();
+  printf("accept: %.0f samples in %.3f s (%.1f ns each, %u passed)\n", n, s, s * 1e9 / n,
+         passed);
+}
+
+int main() {
+  checkAccuracy();
+  checkWindows();
+  checkDecimation();
+  checkDeadband();
+  checkVolume();
+  benchAccept();
+
+  return checkResult();
+}
@@ -0,0 +1,28 @@
+/*
+ * Shared fixture for the host checks in bench/
+ * check() prints and counts each failed check; checkResult() ends main()
+ * with the summary and the exit code.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+// quiet: no "All checks passed" line, for programs whose stdout is JSON Lines
+static int checkResult(bool quiet = false) {
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  if (!quiet) printf("All checks passed\n");
+  return 0;
+}
@@ -0,0 +1,300 @@
+/*
+ * Host check and benchmark for the sample history store
+ * Checks latest-N, time-range, aggregate and LTTB queries against a plain
+ * std::vector reference (ring reuse, micros() rollover, failed reads,
+ * series limit, no heap use while recording), then measures what each
+ * query costs as one series' history grows, one JSON object per line.
+ *
+ * Build: g++ -O2 -std=gnu++17 -Isim -Iinclude bench/history_bench.cpp -o history_bench
+ * Usage: history_bench [--max-points 1048576]
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include "HistoryStore.h"
+#include "check.h"
+
+// ========== HEAP ALLOCATION COUNTER ==========
+
+static std::atomic<uint64_t> heapAllocs{0};
+
+void* operator new(size_t size) {
+  heapAllocs.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+static float noise(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return (int32_t)(state >> 8) / 8388608.0f - 1.0f;
+}
+
+// ========== REFERENCE ==========
+
+// What the store should hold for one series: the newest `capacity` points
+struct Reference {
+  std::vector<HistoryPoint> points;
+  size_t capacity;
+
+  void add(uint64_t t, float v) {
+    HistoryPoint p = {t, v};
+    points.push_back(p);
+  }
+
+  // Oldest segments go first, so keep whole segments like the store does
+  std::vector<HistoryPoint> held(size_t segmentPoints) const {
+    size_t segmentsHeld = capacity / segmentPoints;
+    size_t total = points.size();
+    size_t lastSegment = (total - 1) / segmentPoints;
+    size_t firstSegment = lastSegment + 1 >= segmentsHeld ? lastSegment + 1 - segmentsHeld : 0;
+    return std::vector<HistoryPoint>(points.begin() + firstSegment * segmentPoints, points.end());
+  }
+};
+
+static bool samePoints(const HistoryPoint* a, const HistoryPoint* b, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (a[i].timeUs != b[i].timeUs || a[i].value != b[i].value) return false;
+  }
+  return true;
+}
+
+// Straightforward LTTB over a vector, in double
+static std::vector<HistoryPoint> referenceLttb(const std::vector<HistoryPoint>& x, size_t m) {
+  std::vector<HistoryPoint> out;
+  size_t n = x.size();
+  double every = (double)(n - 2) / (m - 2);
+  size_t a = 0;
+  out.push_back(x[0]);
+  for (size_t b = 0; b < m - 2; b++) {
+    size_t avgStart = std::min(n - 1, (size_t)((b + 1) * every) + 1);
+    size_t avgEnd = std::max(avgStart + 1, std::min(n, (size_t)((b + 2) * every) + 1));
+    double avgT = 0, avgV = 0;
+    for (size_t i = avgStart; i < avgEnd; i++) {
+      avgT += (double)(x[i].timeUs - x[a].timeUs);
+      avgV += x[i].value - x[a].value;
+    }
+    avgT /= avgEnd - avgStart;
+    avgV /= avgEnd - avgStart;
+    size_t from = (size_t)(b * every) + 1, to = (size_t)((b + 1) * every) + 1;
+    double best = -1;
+    size_t pick = from;
+    for (size_t i = from; i < to; i++) {
+      double area = fabs((double)(x[i].timeUs - x[a].timeUs) * avgV -
+                         avgT * (x[i].value - x[a].value));
+      if (area > best) {
+        best = area;
+        pick = i;
+      }
+    }
+    out.push_back(x[pick]);
+    a = pick;
+  }
+  out.push_back(x[n - 1]);
+  return out;
+}
+
+// ========== CHECKS ==========
+
+static void checkQueries() {
+  const uint32_t segmentPoints = 64;
+  HistoryStore store;
+  check(store.begin(4 * 4096, 4, segmentPoints), "begin failed");
+  Reference ref;
+  ref.capacity = 4096;
+
+  // 1 kHz with jitter, crossing the 32-bit microsecond rollover
+  uint32_t state = 7;
+  uint32_t raw = 0xFFFFFFFFu - 5000000u;
+  uint64_t t = 0;
+  for (int i = 0; i < 10000; i++) {
+    uint32_t step = 1000 + (uint32_t)(100 * noise(state));
+    raw += step;
+    float v = 20.0f + sinf(i * 0.01f) + 0.05f * noise(state);
+    bool ok = store.record(3, 0, SAMPLE_OK, v, raw);
+    if (i == 0) t = store.timeOf(raw);
+    else t += step;
+    ref.add(t, v);
+    check(ok, "record refused a sample");
+    if (i % 100 == 0) store.record(3, 0, SAMPLE_ERROR, 0, raw);
+  }
+  std::vector<HistoryPoint> held = ref.held(segmentPoints);
+  HistoryInfo info = store.info(3, 0);
+  check(info.count == held.size(), "info: wrong count after ring reuse");
+  check(info.oldestUs == held.front().timeUs && info.newestUs == held.back().timeUs,
+        "info: wrong span");
+  check(info.missed == 100, "info: failed reads not counted");
+
+  std::vector<HistoryPoint> out(held.size() + 10);
+  size_t n = store.latest(3, 0, out.data(), 10);
+  check(n == 10 && samePoints(out.data(), &held[held.size() - 10], 10), "latest: wrong points");
+  n = store.latest(3, 0, out.data(), out.size());
+  check(n == held.size() && samePoints(out.data(), held.data(), n), "latest: all points");
+
+  // Time ranges and aggregates against a scan of the reference
+  for (int q = 0; q < 200; q++) {
+    uint64_t span = held.back().timeUs - held.front().timeUs;
+    uint64_t from = held.front().timeUs - 5000 + (uint64_t)((noise(state) + 1) * 0.5f * span);
+    uint64_t to = from + (uint64_t)((noise(state) + 1) * 0.25f * span);
+    if (q == 0) from = held[100].timeUs, to = held[200].timeUs;  // Exact boundaries
+
+    std::vector<HistoryPoint> want;
+    double sum = 0;
+    float lo = INFINITY, hi = -INFINITY;
+    for (const HistoryPoint& p : held) {
+      if (p.timeUs < from || p.timeUs > to) continue;
+      want.push_back(p);
+      sum += p.value;
+      lo = std::min(lo, p.value);
+      hi = std::max(hi, p.value);
+    }
+    n = store.range(3, 0, from, to, out.data(), out.size());
+    check(n == want.size() && samePoints(out.data(), want.data(), n), "range: wrong points");
+
+    HistoryAggregate a = store.aggregate(3, 0, from, to);
+    check(a.count == want.size(), "aggregate: wrong count");
+    if (!want.empty()) {
+      check(a.min == lo && a.max == hi, "aggregate: wrong min/max");
+      check(fabs(a.mean - sum / want.size()) < 1e-4, "aggregate: wrong mean");
+      check(a.firstUs == want.front().timeUs && a.lastUs == want.back().timeUs,
+            "aggregate: wrong span");
+    }
+  }
+  check(store.aggregate(3, 0, 0, UINT64_MAX).count == held.size(), "aggregate: open range");
+
+  // LTTB picks the same points as the reference
+  n = store.downsample(3, 0, 0, UINT64_MAX, out.data(), 300);
+  std::vector<HistoryPoint> want = referenceLttb(held, 300);
+  size_t same = 0;
+  for (size_t i = 0; i < n && i < want.size(); i++) same += out[i].timeUs == want[i].timeUs;
+  check(n == 300, "downsample: wrong point count");
+  check(out[0].timeUs == held.front().timeUs && out[n - 1].timeUs == held.back().timeUs,
+        "downsample: ends not kept");
+  check(same >= n * 98 / 100, "downsample: differs from reference LTTB");
+  n = store.downsample(3, 0, held[10].timeUs, held[19].timeUs, out.data(), 300);
+  check(n == 10, "downsample: short range not returned whole");
+
+  // Unknown series, failed reads only, series limit
+  check(store.latest(9, 0, out.data(), 10) == 0, "unknown series returned points");
+  store.record(4, 0, SAMPLE_NO_DEVICE, 0, raw);
+  check(store.info(4, 0).count == 0 && store.info(4, 0).missed == 1, "failed-only series");
+  store.record(5, 1, SAMPLE_OK, 1, raw);
+  store.record(5, 2, SAMPLE_OK, 1, raw);
+  check(!store.record(5, 3, SAMPLE_OK, 1, raw) && store.unmappedCount() == 1,
+        "series limit not enforced");
+}
+
+// A single spike in a flat signal must survive downsampling
+static void checkSpike() {
+  HistoryStore store;
+  store.begin(100000, 1);
+  for (uint32_t i = 0; i < 100000; i++) {
+    store.record(1, 0, SAMPLE_OK, i == 61234 ? 50.0f : 1.0f, 1000 + i * 100);
+  }
+  HistoryPoint out[100];
+  size_t n = store.downsample(1, 0, 0, UINT64_MAX, out, 100);
+  bool found = false;
+  for (size_t i = 0; i < n; i++) found |= out[i].value == 50.0f;
+  check(found, "downsample: spike lost");
+}
+
+// Recording and querying a full store doesn't touch the heap
+static void checkNoAllocation() {
+  HistoryStore store;
+  store.begin(65536, 8);
+  HistoryPoint out[64];
+  uint64_t before = heapAllocs.load();
+  for (uint32_t i = 0; i < 200000; i++) {
+    store.record(i % 8, 0, SAMPLE_OK, (float)i, i * 10);
+    if (i % 1000 == 0) {
+      store.latest(1, 0, out, 64);
+      store.aggregate(2, 0, 0, UINT64_MAX);
+      store.downsample(3, 0, 0, UINT64_MAX, out, 64);
+    }
+  }
+  check(heapAllocs.load() == before, "steady state allocated");
+}
+
+// ========== BENCH ==========
+
+template <typename Fn>
+static double nsPerCall(Fn fn) {
+  int rounds = 1;
+  for (;;) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) fn();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (s > 0.05 || rounds >= (1 << 20)) return s * 1e9 / rounds;
+    rounds *= 4;
+  }
+}
+
+static volatile float sink;
+
+static void benchGrowth(size_t maxPoints) {
+  static HistoryPoint out[1000];
+  for (size_t points = 4096; points <= maxPoints; points *= 4) {
+    HistoryStore store;
+    if (!store.begin(points, 1)) continue;
+    uint32_t state = 11;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < points; i++) {
+      store.record(1, 0, SAMPLE_OK, 20.0f + noise(state), 1000 + (uint32_t)i * 1000);
+    }
+    double recordNs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                          .count() * 1e9 / points;
+    HistoryInfo info = store.info(1, 0);
+    uint64_t newest = info.newestUs;
+    uint64_t oldest = info.oldestUs;
+
+    double latestNs = nsPerCall([&] { sink = out[store.latest(1, 0, out, 100) - 1].value; });
+    double rangeNs = nsPerCall([&] {  // Last second: 1000 points
+      sink = out[store.range(1, 0, newest - 999000, newest, out, 1000) - 1].value;
+    });
+    double aggregateAllNs = nsPerCall([&] { sink = store.aggregate(1, 0, 0, UINT64_MAX).mean; });
+    double aggregateTailNs = nsPerCall([&] {  // Newest 10%
+      sink = store.aggregate(1, 0, newest - (newest - oldest) / 10, newest).mean;
+    });
+    double lttbNs = nsPerCall([&] {
+      sink = out[store.downsample(1, 0, 0, UINT64_MAX, out, 500) - 1].value;
+    });
+    printf("{\"bench\":\"history\",\"points\":%u,\"memory_bytes\":%zu,\"record_ns\":%.1f,"
+           "\"latest_100_ns\":%.0f,\"range_1000_ns\":%.0f,\"aggregate_all_ns\":%.0f,"
+           "\"aggregate_tail_10pct_ns\":%.0f,\"lttb_500_ns\":%.0f}\n",
+           info.count, store.memoryBytes(), recordNs, latestNs, rangeNs, aggregateAllNs,
+           aggregateTailNs, lttbNs);
+  }
+}
+
+int main(int argc, char** argv) {
+  size_t maxPoints = 1 << 20;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--max-points" && i + 1 < argc) {
+      maxPoints = std::max(4096, atoi(argv[++i]));
+    } else {
+      fprintf(stderr, "usage: %s [--max-points N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  checkQueries();
+  checkSpike();
+  checkNoAllocation();
+  benchGrowth(maxPoints);
+
+  return checkResult(true);
+}
@@ -0,0 +1,152 @@
+/*
+ * Host stress test for I2C hot-plug under running acquisition
+ * The acquisition thread scans with background discovery on while the
+ * main thread, like loop(), plugs and unplugs simulated I2C devices,
+ * applies what discovery found with syncI2CChannels() and drains samples.
+ * Each applied change rebuilds the tables the scan thread is reading; the
+ * scan lock must keep every rebuild between two scans. The frame starts
+ * sized for the fixed channels, so hot-plugged channels only show up if
+ * the frame grows with them. Build it with
+ * -fsanitize=address (or thread) to have use-after-free or races fail the
+ * run instead of going unnoticed.
+ *
+ * Build: g++ -O1 -g -std=gnu++17 -pthread -fsanitize=address -Isim -Iinclude -Isrc
+ *        -I<ArduinoJson>/src -DARDUINOJSON_ENABLE_ARDUINO_STRING=1
+ *        -DARDUINOJSON_ENABLE_ARDUINO_STREAM=1 -DARDUINOJSON_ENABLE_ARDUINO_PRINT=1
+ *        bench/hotplug_stress.cpp sim/SimHardware.cpp -o hotplug_stress
+ * Usage: hotplug_stress [--ms 2000] [--sd DIR]
+ */
+
+#include <stdio.h>
+#include <string>
+#include "ConfigLib.ino"
+#include "check.h"
+
+#define FIRST_PLUG 0x20
+#define PLUG_COUNT 16  // Addresses the main thread plugs and unplugs
+
+static uint32_t nextRandom(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+// Only presence changes while scanning; registers are set before the start
+static void setDevice(uint8_t address, bool present) {
+  if (present) {
+    Sim.addI2CDevice(address);
+  } else {
+    Sim.removeI2CDevice(address);
+  }
+}
+
+int main(int argc, char** argv) {
+  uint32_t runMs = 2000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    if (arg == "--ms") {
+      runMs = std::max(1, atoi(argv[i + 1]));
+    } else if (arg == "--sd") {
+      Sim.setSdRoot(argv[i + 1]);
+    } else {
+      fprintf(stderr, "usage: %s [--ms N] [--sd DIR]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  Serial.setOutput(nullptr);
+  if (!config.begin()) {
+    fprintf(stderr, "SD root %s not usable\n", Sim.getSdRoot().c_str());
+    return 1;
+  }
+  config.getFixedChannels().clear();
+  config.getI2CChannels().clear();
+  Sim.setDigital(2, 1);
+  Sim.setAnalog(4, 1234);
+  FixedChannel digital = FixedChannel();
+  digital.channel = 1;
+  digital.pin = 2;
+  digital.mode = "DIGITAL";
+  digital.active = true;
+  FixedChannel analog = digital;
+  analog.channel = 2;
+  analog.pin = 4;
+  analog.mode = "ANALOG";
+  config.getFixedChannels().push_back(digital);
+  config.getFixedChannels().push_back(analog);
+  config.rebuildChannelTable();
+  config.setI2CDiscoveryRate(16);
+  for (int k = 0; k < PLUG_COUNT; k++) {
+    const uint8_t reading[] = {0, (uint8_t)k};
+    Sim.setI2CRegisters(FIRST_PLUG + k, 0x00, reading, sizeof(reading));
+  }
+
+  bool present[PLUG_COUNT] = {false};
+  // Sized for the two fixed channels only: hot-plugged ones must grow the frame
+  if (!acquisition.start(acquisitionScan, &config, config.scanSize(), 8192, 0)) {
+    printf("FAIL: acquisition did not start\n");
+    return 1;
+  }
+
+  // loop(): plug, unplug, apply, drain
+  uint32_t state = 7;
+  uint32_t syncs = 0;
+  uint32_t changes = 0;
+  uint32_t plugs = 0;
+  size_t drained = 0;
+  bool hotPlugSampled = false;
+  Sample samples[256];
+  uint32_t start = millis();
+  while (millis() - start < runMs) {
+    if (nextRandom(state) % 4 == 0) {
+      int k = nextRandom(state) % PLUG_COUNT;
+      present[k] = !present[k];
+      setDevice(FIRST_PLUG + k, present[k]);
+      plugs++;
+    }
+    if (config.i2cChangesPending()) {
+      changes += config.syncI2CChannels();
+      syncs++;
+    }
+    size_t n = acquisition.drain(samples, 256);
+    for (size_t i = 0; i < n; i++) {
+      if (samples[i].channel > MAX_FIXED_CHANNELS && samples[i].status == SAMPLE_OK) {
+        hotPlugSampled = true;
+      }
+    }
+    drained += n;
+    delay(1);
+  }
+  uint32_t scansWhileRunning = acquisition.scanCount();
+
+  // Settle: everything plugged, two full sweeps, then apply
+  for (int k = 0; k < PLUG_COUNT; k++) {
+    present[k] = true;
+    setDevice(FIRST_PLUG + k, true);
+  }
+  uint32_t settleScans = acquisition.scanCount() + 3 * (112 / 16 + 1);
+  uint32_t settleStart = millis();
+  while (acquisition.scanCount() < settleScans && millis() - settleStart < 2000) {
+    drained += acquisition.drain(samples, 256);
+    delay(1);
+  }
+  if (config.i2cChangesPending()) changes += config.syncI2CChannels();
+  acquisition.stop();
+
+  int active = 0;
+  for (const auto& ch : config.getI2CChannels()) {
+    bool plugged = ch.address >= FIRST_PLUG && ch.address < FIRST_PLUG + PLUG_COUNT;
+    if (plugged && ch.active) active++;
+  }
+
+  check(scansWhileRunning > runMs / 10, "acquisition stalled during hot-plug");
+  check(syncs > 0 && changes > 0, "no hot-plug changes were applied");
+  check(hotPlugSampled, "no samples from hot-plugged channels");
+  check(active == PLUG_COUNT, "plugged devices missing an active channel");
+  check(config.getI2CChannels().size() == PLUG_COUNT, "a device got two channels");
+  check(config.getTruncatedValues() == 0, "scans were cut off by the frame size");
+  printf("hotplug: %u scans, %u plug events, %u syncs, %u channel changes, %u samples in %u ms\n",
+         (unsigned)scansWhileRunning, (unsigned)plugs, (unsigned)syncs, (unsigned)changes,
+         (unsigned)drained, (unsigned)runMs);
+
+  return checkResult();
+}
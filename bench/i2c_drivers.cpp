@@ -0,0 +1,88 @@
+/*
+ * Host check for the built-in I2C driver decoders
+ * Feeds decodeBMP280() the calibration and raw readings of the worked
+ * example in the Bosch BMP280 datasheet and checks its results, then
+ * decodes an MPU-6050 burst built from known register values at +-2 g /
+ * +-250 dps.
+ *
+ * Build: g++ -O2 -std=gnu++17 -pthread -Isim -Iinclude bench/i2c_drivers.cpp
+ *        sim/SimHardware.cpp -o i2c_drivers
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "I2CDrivers.h"
+#include "check.h"
+
+static bool near(float a, float b, float tolerance) {
+  return fabsf(a - b) <= tolerance;
+}
+
+// 20-bit ADC value as the msb, lsb, xlsb registers hold it
+static void putAdc20(uint8_t* p, int32_t adc) {
+  p[0] = adc >> 12;
+  p[1] = adc >> 4;
+  p[2] = (adc << 4) & 0xF0;
+}
+
+static void putLE16(uint8_t* p, int v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+}
+
+static void putBE16(uint8_t* p, int v) {
+  p[0] = (v >> 8) & 0xFF;
+  p[1] = v & 0xFF;
+}
+
+static void checkBMP280() {
+  // dig_T1..dig_T3, dig_P1..dig_P9 from the datasheet example
+  const int trim[12] = {27504, 26435, -1000, 36477, -10685, 3024,
+                        2855,  140,   -7,    15500, -14600, 6000};
+  uint8_t cal[24];
+  for (int i = 0; i < 12; i++) putLE16(cal + 2 * i, trim[i]);
+
+  uint8_t raw[6];
+  putAdc20(raw, 415148);      // press_msb..press_xlsb
+  putAdc20(raw + 3, 519888);  // temp_msb..temp_xlsb
+
+  float out[I2C_MAX_VALUES] = {0};
+  decodeBMP280(raw, sizeof(raw), cal, out);
+  check(near(out[0], 25.08f, 0.005f), "bmp280: temperature is not 25.08 C");
+  check(near(out[1], 1006.53f, 0.005f), "bmp280: pressure is not 1006.53 hPa");
+  printf("bmp280: %.2f C, %.2f hPa\n", out[0], out[1]);
+
+  // All-zero calibration (device not answering at init) must not divide by zero
+  uint8_t zero[24] = {0};
+  decodeBMP280(raw, sizeof(raw), zero, out);
+  check(out[1] == 0, "bmp280: uncalibrated pressure not 0");
+
+  const I2CDriver* driver = findI2CDriver("bmp280");
+  check(driver && driver->calReg == 0x88 && driver->calLen == sizeof(cal) &&
+            driver->burstReg == 0xF7 && driver->burstLen == sizeof(raw),
+        "bmp280: register layout");
+}
+
+static void checkMPU6050() {
+  // ACCEL_XOUT_H..GYRO_ZOUT_L, temperature between the two
+  const int regs[7] = {16384, -8192, 0, -521, 131, -262, 13100};
+  uint8_t raw[14];
+  for (int i = 0; i < 7; i++) putBE16(raw + 2 * i, regs[i]);
+
+  float out[I2C_MAX_VALUES] = {0};
+  decodeMPU6050(raw, sizeof(raw), nullptr, out);
+  check(out[0] == 1.0f && out[1] == -0.5f && out[2] == 0, "mpu6050: acceleration in g");
+  check(out[3] == 1.0f && out[4] == -2.0f && out[5] == 100.0f, "mpu6050: rotation in dps");
+  check(near(out[6], 35.0f, 0.01f), "mpu6050: temperature");
+
+  const I2CDriver* driver = findI2CDriver("mpu6050");
+  check(driver && driver->burstReg == 0x3B && driver->burstLen == sizeof(raw) &&
+            driver->valueCount == 7,
+        "mpu6050: register layout");
+}
+
+int main() {
+  checkBMP280();
+  checkMPU6050();
+  return checkResult();
+}
@@ -0,0 +1,474 @@
+/*
+ * Host benchmark suite: read path, scans, config I/O and I2C discovery
+ * Runs ConfigLib unchanged against sim/ and prints one JSON object per line
+ * (JSON Lines) on stdout, so results can be appended to a file and tracked.
+ * Each measurement runs under two latency profiles: "none" (code cost only)
+ * and "typical" (modeled ESP32-S3 bus time, see SimLatency::typical()).
+ *
+ * Build: pio run -e native   (or: g++ -O2 -std=gnu++17 -pthread -Isim -Iinclude -Isrc
+ *        -I<ArduinoJson>/src -DARDUINOJSON_ENABLE_ARDUINO_STRING=1
+ *        -DARDUINOJSON_ENABLE_ARDUINO_STREAM=1 -DARDUINOJSON_ENABLE_ARDUINO_PRINT=1
+ *        bench/scan_bench.cpp sim/SimHardware.cpp -o scan_bench)
+ * Usage: scan_bench [--profile none|typical|all] [--ms 200] [--sd DIR] >> bench.jsonl
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include "ConfigLib.ino"
+
+// ========== HEAP ALLOCATION COUNTER ==========
+
+static std::atomic<uint64_t> heapAllocs{0};
+
+void* operator new(size_t size) {
+  heapAllocs.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  free(p);
+}
+
+// ========== HELPERS ==========
+
+static uint32_t benchMs = 200;
+
+static uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t percentile(std::vector<uint64_t>& v, double p) {
+  if (v.empty()) return 0;
+  size_t i = (size_t)(p * (v.size() - 1));
+  std::nth_element(v.begin(), v.begin() + i, v.end());
+  return v[i];
+}
+
+static double mean(const std::vector<uint64_t>& v) {
+  if (v.empty()) return 0;
+  double sum = 0;
+  for (uint64_t x : v) sum += x;
+  return sum / v.size();
+}
+
+// One JSON object per output line
+class JsonLine {
+private:
+  std::string buf;
+
+  void key(const char* k) {
+    buf += buf.empty() ? "{\"" : ",\"";
+    buf += k;
+    buf += "\":";
+  }
+
+public:
+  JsonLine& add(const char* k, const char* v) {
+    key(k);
+    buf += "\"";
+    buf += v;
+    buf += "\"";
+    return *this;
+  }
+
+  JsonLine& add(const char* k, double v) {
+    char num[32];
+    snprintf(num, sizeof(num), "%.6g", v);
+    key(k);
+    buf += num;
+    return *this;
+  }
+
+  void print() {
+    printf("%s}\n", buf.c_str());
+    fflush(stdout);
+  }
+};
+
+// Discards deferred log output between timed reads
+class NullPrint : public Print {
+public:
+  size_t write(uint8_t) override {
+    return 1;
+  }
+
+  size_t write(const uint8_t*, size_t n) override {
+    return n;
+  }
+};
+
+static NullPrint nullPrint;
+
+// ========== CHANNEL LAYOUT ==========
+
+// Fixed channel pins, skipping SD (10-13) and I2C (21, 22)
+static const int BENCH_PINS[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 14, 15, 16, 17, 18, 19, 20,
+                                 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36};
+static const int ONEWIRE_PINS[] = {37, 38};
+
+// Mixed layout: one I2C channel in ten (all channels past MAX_FIXED_CHANNELS
+// are I2C), fixed channels cycle 3 DIGITAL, 3 ANALOG, 1 SPI, 2 ONEWIRE.
+// Every channel gets a simulated device that answers.
+static void buildChannels(int total) {
+  Sim.reset();
+  std::vector<FixedChannel>& fixed = config.getFixedChannels();
+  std::vector<I2CChannel>& i2c = config.getI2CChannels();
+  fixed.clear();
+  i2c.clear();
+
+  int i2cCount = std::max(total / 10, total - MAX_FIXED_CHANNELS);
+  int fixedCount = total - i2cCount;
+  int oneWireSensors[2] = {0, 0};
+
+  for (int i = 0; i < fixedCount; i++) {
+    FixedChannel fc = FixedChannel();  // Zero rate, SPI and filter settings
+    fc.channel = i + 1;
+    fc.pin = BENCH_PINS[i];
+    fc.mode = "DIGITAL";
+    fc.active = true;
+    switch (i % 9) {
+      case 0: case 1: case 2:
+        Sim.setDigital(fc.pin, i & 1);
+        break;
+      case 3: case 4: case 5:
+        fc.mode = "ANALOG";
+        Sim.setAnalog(fc.pin, 100 * i);
+        break;
+      case 6: {
+        fc.mode = "SPI";
+        const uint8_t response[] = {(uint8_t)i};
+        Sim.addSpiDevice(fc.pin, response, sizeof(response));
+        break;
+      }
+      default: {
+        int bus = i % 2;
+        fc.mode = "ONEWIRE";
+        fc.pin = ONEWIRE_PINS[bus];
+        fc.sensor = oneWireSensors[bus]++;
+        Sim.addDS18B20(fc.pin, 20.0f + 0.5f * i);
+        break;
+      }
+    }
+    fixed.push_back(fc);
+  }
+
+  for (int i = 0; i < i2cCount; i++) {
+    uint8_t address = 0x08 + i;
+    const uint8_t reading[] = {(uint8_t)(i >> 8), (uint8_t)i};
+    Sim.addI2CDevice(address);
+    Sim.setI2CRegisters(address, 0x00, reading, sizeof(reading));
+    I2CChannel ic = I2CChannel();  // Zero rate and filter settings, no driver
+    ic.channel = MAX_FIXED_CHANNELS + 1 + i;
+    ic.id = i;
+    ic.address = address;
+    ic.active = true;
+    ic.reg = 0x00;
+    ic.length = 2;
+    i2c.push_back(ic);
+  }
+
+  config.rebuildChannelTable();
+}
+
+// Scan until every DS18B20 has a first conversion, so timings are steady-state
+static void warmUp(ScanFrame& frame) {
+  SimLatency saved = Sim.getLatency();
+  Sim.setLatency(SimLatency::none());
+  uint32_t start = millis();
+  bool ready = false;
+  while (!ready && millis() - start < 2000) {
+    config.scanAll(frame);
+    ready = true;
+    for (size_t i = 0; i < frame.count; i++) {
+      if (frame.status[i] == SAMPLE_NOT_READY) ready = false;
+    }
+    delay(5);
+  }
+  Sim.setLatency(saved);
+}
+
+// ========== BENCHMARKS ==========
+
+// Per-read cost of readChannel() for every channel of the 10-channel layout.
+// OneWire reads are mostly cheap cache hits with a periodic bus collect.
+static void benchReadLatency(const char* profile) {
+  buildChannels(10);
+  ScanFrame frame;
+  frame.reserve(config.scanSize());
+  warmUp(frame);
+
+  std::vector<int> channels = config.getActiveChannelList();
+  std::vector<uint64_t> samples;
+  samples.reserve(1 << 20);
+
+  for (int ch : channels) {
+    samples.clear();
+    uint64_t allocs = heapAllocs.load();
+    uint64_t end = nowNs() + benchMs * 1000000ULL;
+    while (nowNs() < end && samples.size() < samples.capacity()) {
+      uint64_t t0 = nowNs();
+      readChannel(ch);
+      samples.push_back(nowNs() - t0);
+      if ((samples.size() & 127) == 0) eventLog.flush(nullPrint, LOG_RING_SIZE);
+    }
+    allocs = heapAllocs.load() - allocs;
+    eventLog.flush(nullPrint, LOG_RING_SIZE);
+
+    const ChannelSlot* slot = config.findChannel(ch);
+    double meanNs = mean(samples);
+    JsonLine()
+        .add("bench", "read_latency")
+        .add("profile", profile)
+        .add("channel", ch)
+        .add("type", channelTypeName(slot ? slot->type : CH_NONE))
+        .add("reads", samples.size())
+        .add("mean_ns", meanNs)
+        .add("p50_ns", percentile(samples, 0.50))
+        .add("p99_ns", percentile(samples, 0.99))
+        .add("max_ns", percentile(samples, 1.0))
+        .add("allocs_per_read", (double)allocs / samples.size())
+        .print();
+  }
+}
+
+// Full scanAll() throughput at a given channel count
+static void benchScan(const char* profile, int total) {
+  buildChannels(total);
+  ScanFrame frame;
+  frame.reserve(config.scanSize());
+  warmUp(frame);
+
+  std::vector<uint64_t> samples;
+  samples.reserve(1 << 18);
+  Sim.resetCounters();
+  uint64_t allocs = heapAllocs.load();
+  uint64_t start = nowNs();
+  uint64_t end = start + benchMs * 1000000ULL;
+  size_t sampleCount = 0;
+
+  while (nowNs() < end && samples.size() < samples.capacity()) {
+    uint64_t t0 = nowNs();
+    sampleCount += config.scanAll(frame);
+    samples.push_back(nowNs() - t0);
+  }
+
+  double elapsedS = (nowNs() - start) / 1e9;
+  double scans = samples.size();
+  allocs = heapAllocs.load() - allocs;
+  const SimCounters& c = Sim.getCounters();
+
+  JsonLine()
+      .add("bench", "scan")
+      .add("profile", profile)
+      .add("channels", total)
+      .add("scans", scans)
+      .add("scans_per_s", scans / elapsedS)
+      .add("samples_per_s", sampleCount / elapsedS)
+      .add("mean_us", mean(samples) / 1000)
+      .add("p99_us", percentile(samples, 0.99) / 1000.0)
+      .add("max_us", percentile(samples, 1.0) / 1000.0)
+      .add("allocs_per_scan", allocs / scans)
+      .add("gpio_ops_per_scan", c.digitalOps / scans)
+      .add("spi_transactions_per_scan", c.spiTransactions / scans)
+      .add("i2c_transactions_per_scan", c.i2cTransactions / scans)
+      .add("onewire_bytes_per_scan", c.oneWireBytes / scans)
+      .print();
+}
+
+// Cost of the read instrumentation. Measured directly (timing and counting
+// one read, times reads per scan, over the plain scan time) and as an A/B
+// of 100-channel scans alternating between blocks with it on and off, so
+// drift in host speed hits both alike. The A/B is only as good as the
+// scan-to-scan noise of the profile.
+static void benchReadStats(const char* profile) {
+  const int total = 100;
+  buildChannels(total);
+  ScanFrame frame;
+  frame.reserve(config.scanSize());
+  warmUp(frame);
+
+  // Blocks of about a millisecond, at least one scan
+  uint64_t t0 = nowNs();
+  config.scanAll(frame);
+  int perBlock = (int)std::max<uint64_t>(1, 1000000 / std::max<uint64_t>(1, nowNs() - t0));
+
+  resetReadStats();
+  uint64_t onNs = 0, offNs = 0;
+  uint64_t onScans = 0, offScans = 0;
+  uint64_t end = nowNs() + benchMs * 1000000ULL;
+  for (int block = 0; nowNs() < end || offScans == 0; block++) {
+    bool on = block % 2 == 0;
+    setReadStatsEnabled(on);
+    t0 = nowNs();
+    for (int i = 0; i < perBlock; i++) config.scanAll(frame);
+    (on ? onNs : offNs) += nowNs() - t0;
+    (on ? onScans : offScans) += perBlock;
+  }
+  setReadStatsEnabled(true);
+
+  const ReadStatsCollector& stats = config.getReadStats();
+  uint64_t reads = 0;
+  for (int b = 0; b < BUS_COUNT; b++) reads += stats.getBus((ScanBus)b).time.count;
+  double readsPerScan = stats.getScans().count ? (double)reads / stats.getScans().count : 0;
+
+  ReadStatsCollector probe;
+  probe.configure(128);
+  const int rounds = 1000000;
+  t0 = nowNs();
+  for (int i = 0; i < rounds; i++) {
+    uint32_t start = cycleCount();
+    probe.recordRead(i & 127, BUS_I2C, SAMPLE_OK, cycleCount() - start, false);
+  }
+  double perReadNs = (double)(nowNs() - t0) / rounds;
+
+  double onUs = onScans ? onNs / 1000.0 / onScans : 0;
+  double offUs = offScans ? offNs / 1000.0 / offScans : 0;
+  JsonLine()
+      .add("bench", "read_stats")
+      .add("profile", profile)
+      .add("channels", total)
+      .add("reads_per_scan", readsPerScan)
+      .add("ns_per_read", perReadNs)
+      .add("overhead_pct", offUs > 0 ? readsPerScan * perReadNs / 1000 / offUs * 100 : 0)
+      .add("scan_us_instrumented", onUs)
+      .add("scan_us_plain", offUs)
+      .add("ab_overhead_pct", offUs > 0 ? (onUs - offUs) / offUs * 100 : 0)
+      .print();
+}
+
+// saveConfig() and both loadConfig() paths for the 100-channel layout
+static void benchConfigIO(const char* profile) {
+  const int total = 100;
+  const int rounds = 10;
+  buildChannels(total);
+
+  std::vector<uint64_t> save, loadSnapshot, loadJson;
+  uint64_t saveAllocs = 0, snapshotAllocs = 0, jsonAllocs = 0;
+  for (int r = 0; r < rounds; r++) {
+    uint64_t a0 = heapAllocs.load();
+    uint64_t t0 = nowNs();
+    config.saveConfig();
+    uint64_t t1 = nowNs();
+    uint64_t a1 = heapAllocs.load();
+    config.loadConfig(true);
+    uint64_t t2 = nowNs();
+    uint64_t a2 = heapAllocs.load();
+    config.loadConfig(false);
+    uint64_t t3 = nowNs();
+    uint64_t a3 = heapAllocs.load();
+
+    save.push_back(t1 - t0);
+    loadSnapshot.push_back(t2 - t1);
+    loadJson.push_back(t3 - t2);
+    saveAllocs += a1 - a0;
+    snapshotAllocs += a2 - a1;
+    jsonAllocs += a3 - a2;
+  }
+
+  JsonLine()
+      .add("bench", "config_io")
+      .add("profile", profile)
+      .add("channels", total)
+      .add("loaded_channels", config.getActiveChannelCount())
+      .add("save_us", mean(save) / 1000)
+      .add("load_snapshot_us", mean(loadSnapshot) / 1000)
+      .add("load_json_us", mean(loadJson) / 1000)
+      .add("allocs_per_save", (double)saveAllocs / rounds)
+      .add("allocs_per_load_snapshot", (double)snapshotAllocs / rounds)
+      .add("allocs_per_load_json", (double)jsonAllocs / rounds)
+      .print();
+}
+
+// Full I2C discovery pass (probe 0x08-0x77 and sync) with 70 devices on the bus
+static void benchDiscovery(const char* profile) {
+  const int rounds = 10;
+  buildChannels(100);
+  config.discoverI2C();  // Settle: the first pass may change channels
+
+  std::vector<uint64_t> samples;
+  int changes = 0;
+  for (int r = 0; r < rounds; r++) {
+    uint64_t t0 = nowNs();
+    changes += config.discoverI2C();
+    samples.push_back(nowNs() - t0);
+  }
+
+  JsonLine()
+      .add("bench", "i2c_discovery")
+      .add("profile", profile)
+      .add("devices", (int)config.getI2CChannels().size())
+      .add("full_scan_us", mean(samples) / 1000)
+      .add("max_us", percentile(samples, 1.0) / 1000.0)
+      .add("changes", changes)
+      .print();
+}
+
+static void runProfile(const char* name, const SimLatency& latency) {
+  Sim.setLatency(latency);
+  benchReadLatency(name);
+  const int sizes[] = {10, 30, 100};
+  for (int total : sizes) benchScan(name, total);
+  benchReadStats(name);
+  benchConfigIO(name);
+  benchDiscovery(name);
+}
+
+// ========== MAIN ==========
+
+int main(int argc, char** argv) {
+  std::string profile = "all";
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    if (arg == "--profile") {
+      profile = argv[i + 1];
+    } else if (arg == "--ms") {
+      benchMs = std::max(1, atoi(argv[i + 1]));
+    } else if (arg == "--sd") {
+      Sim.setSdRoot(argv[i + 1]);
+    } else {
+      fprintf(stderr, "usage: %s [--profile none|typical|all] [--ms N] [--sd DIR]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  Serial.setOutput(nullptr);  // Keep stdout machine-readable
+  if (!config.begin()) {
+    fprintf(stderr, "SD root %s not usable\n", Sim.getSdRoot().c_str());
+    return 1;
+  }
+
+  JsonLine()
+      .add("bench", "meta")
+      .add("suite", "scan_bench")
+      .add("format", 1)
+      .add("bench_ms", benchMs)
+      .add("log_level", LOG_LEVEL)
+      .print();
+
+  if (profile == "none" || profile == "all") runProfile("none", SimLatency::none());
+  if (profile == "typical" || profile == "all") runProfile("typical", SimLatency::typical());
+  return 0;
+}
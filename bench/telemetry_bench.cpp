@@ -0,0 +1,236 @@
+/*
+ * Host benchmark and check for the serial telemetry stream
+ * Sends synthetic scans (digital, raw ADC, DS18B20, counters, BMP280 and
+ * MPU-6050 sub-channels) through TelemetryStream in TEXT and BINARY mode,
+ * decodes the binary capture with TelemetryDecoder and checks it is
+ * bit-exact, then reports bytes per sample and the sustained sample rate
+ * each mode allows on a serial link, one JSON object per line.
+ *
+ * Build: g++ -O2 -std=gnu++17 -pthread -Isim -Iinclude bench/telemetry_bench.cpp
+ *        sim/SimHardware.cpp -o telemetry_bench
+ * Usage: telemetry_bench [--scans 5000] [--link-bytes-per-s 1000000]
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "TelemetryStream.h"
+#include "check.h"
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Collects everything written, like a host on the other end of the cable
+class Capture : public Print {
+public:
+  std::vector<uint8_t> data;
+
+  size_t write(uint8_t c) override {
+    data.push_back(c);
+    return 1;
+  }
+
+  size_t write(const uint8_t* buf, size_t n) override {
+    data.insert(data.end(), buf, buf + n);
+    return n;
+  }
+};
+
+// ========== SYNTHETIC SCANS ==========
+
+static float noise(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return (int32_t)(state >> 8) / 8388608.0f - 1.0f;
+}
+
+static void addSample(ScanFrame& f, uint32_t t, int16_t channel, uint8_t sub, uint8_t status,
+                      float value) {
+  size_t i = f.count++;
+  f.timestampUs[i] = t;
+  f.channel[i] = channel;
+  f.sub[i] = sub;
+  f.status[i] = status;
+  f.value[i] = value;
+}
+
+// 32 samples per scan, one scan per millisecond
+static std::vector<ScanFrame> makeScans(int count) {
+  std::vector<ScanFrame> scans(count);
+  uint32_t state = 5;
+  float temps[4] = {21.5f, 22.0f, 19.25f, 24.0f};
+  float counter = 0;
+  for (int s = 0; s < count; s++) {
+    ScanFrame& f = scans[s];
+    f.reserve(40);
+    uint32_t t = 1000000 + s * 1000;
+    int16_t ch = 1;
+    for (int i = 0; i < 8; i++, t += 2) addSample(f, t, ch++, 0, SAMPLE_OK, (s / 500 + i) & 1);
+    for (int i = 0; i < 8; i++, t += 21) {
+      addSample(f, t, ch++, 0, SAMPLE_OK, (float)(int)(1500 + 200 * i + 8 * noise(state)));
+    }
+    for (int i = 0; i < 4; i++, t += 3) {
+      if (noise(state) > 0.995f) temps[i] += noise(state) > 0 ? 0.0625f : -0.0625f;
+      addSample(f, t, ch++, 0, SAMPLE_OK, temps[i]);
+    }
+    counter += 3;
+    addSample(f, t += 2, ch++, 0, SAMPLE_OK, counter);
+    addSample(f, t += 2, ch++, 0, SAMPLE_OK, 50.0f + 0.01f * noise(state));  // Frequency
+    addSample(f, t += 2, 23, 0, SAMPLE_NO_DEVICE, 0);                        // Unplugged SPI
+    t += 180;
+    addSample(f, t, 31, 0, SAMPLE_OK, 23.41f + 0.01f * (int)(3 * noise(state)));  // BMP280
+    addSample(f, t, 31, 1, SAMPLE_OK, 1006.53f + 0.02f * noise(state));
+    t += 350;
+    for (uint8_t k = 0; k < 7; k++) {  // MPU-6050 burst
+      float v = k < 3 ? (k == 2 ? 1.0f : 0.0f) + 0.01f * noise(state) : 0.5f * noise(state);
+      addSample(f, t, 32, k, SAMPLE_OK, k == 6 ? 36.53f : v);
+    }
+  }
+  return scans;
+}
+
+// ========== DECODE CHECKS ==========
+
+struct Collected {
+  std::vector<TelemetrySample> samples;
+};
+
+static void collect(const TelemetrySample& s, void* context) {
+  ((Collected*)context)->samples.push_back(s);
+}
+
+static bool sameSample(const TelemetrySample& s, const ScanFrame& f, size_t i) {
+  return s.timestampUs == f.timestampUs[i] && s.channel == f.channel[i] && s.sub == f.sub[i] &&
+         s.status == f.status[i] && memcmp(&s.value, &f.value[i], 4) == 0;
+}
+
+// Every sample back, in order and bit-exact
+static bool matches(const std::vector<TelemetrySample>& got, const std::vector<ScanFrame>& scans) {
+  size_t k = 0;
+  for (const ScanFrame& f : scans) {
+    for (size_t i = 0; i < f.count; i++, k++) {
+      if (k >= got.size() || !sameSample(got[k], f, i)) return false;
+    }
+  }
+  return k == got.size();
+}
+
+// Every frame on the wire holds a whole number of scans
+static bool wholeScans(const std::vector<uint8_t>& wire, size_t perScan) {
+  std::vector<uint8_t> frame;
+  uint8_t payload[TELEMETRY_MAX_PAYLOAD + 4];
+  for (uint8_t b : wire) {
+    if (b != 0) {
+      frame.push_back(b);
+      continue;
+    }
+    if (frame.empty()) continue;
+    size_t n = cobsDecode(frame.data(), frame.size(), payload, sizeof(payload));
+    frame.clear();
+    if (n < TELEMETRY_HEADER_SIZE || (payload[8] | (payload[9] << 8)) % perScan != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void checkDamage(const std::vector<uint8_t>& wire, const std::vector<ScanFrame>& scans) {
+  // One flipped byte: that frame is rejected, the rest decode
+  std::vector<uint8_t> damaged = wire;
+  damaged[damaged.size() / 2] ^= 0x10;
+  if (damaged[damaged.size() / 2] == 0) damaged[damaged.size() / 2] = 0x01;
+  TelemetryDecoder decoder;
+  decoder.feed(damaged.data(), damaged.size(), nullptr, nullptr);
+  const TelemetryDecodeStats& s = decoder.getStats();
+  check(s.badFrames == 1 && s.sequenceGaps == 1, "damage: corrupt frame not isolated");
+
+  // Log lines between frames and a capture starting mid-frame
+  std::string text = "I2C Channel 33 added: 0x76\n";
+  std::vector<uint8_t> noisy(wire.begin() + wire.size() / 3, wire.end());
+  size_t cut = noisy.size() / 2;
+  while (noisy[cut] != 0 || noisy[cut + 1] != 0) cut++;  // Between two frames
+  noisy.insert(noisy.begin() + cut + 1, text.begin(), text.end());
+  Collected got;
+  TelemetryDecoder late;
+  late.feed(noisy.data(), noisy.size(), collect, &got);
+  check(!got.samples.empty() && late.getStats().sequenceGaps == 0,
+        "damage: did not resynchronise around text");
+
+  const ScanFrame& last = scans.back();
+  check(sameSample(got.samples.back(), last, last.count - 1), "damage: stream tail lost");
+}
+
+// ========== BENCH ==========
+
+static uint32_t linkBytesPerS = 1000000;
+
+static void report(const char* mode, int pack, size_t samples, size_t bytes, double encodeS,
+                   double decodeS) {
+  double perSample = (double)bytes / samples;
+  printf("{\"bench\":\"telemetry\",\"mode\":\"%s\",\"scans_per_frame\":%d,\"samples\":%zu,"
+         "\"bytes\":%zu,\"bytes_per_sample\":%.3f,\"encode_ns_per_sample\":%.1f,"
+         "\"decode_ns_per_sample\":%.1f,\"link_bytes_per_s\":%u,\"link_samples_per_s\":%.0f}\n",
+         mode, pack, samples, bytes, perSample, encodeS * 1e9 / samples, decodeS * 1e9 / samples,
+         linkBytesPerS, linkBytesPerS / perSample);
+}
+
+int main(int argc, char** argv) {
+  int scanCount = 5000;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--scans" && i + 1 < argc) {
+      scanCount = std::max(1, atoi(argv[++i]));
+    } else if (arg == "--link-bytes-per-s" && i + 1 < argc) {
+      linkBytesPerS = std::max(1, atoi(argv[++i]));
+    } else {
+      fprintf(stderr, "usage: %s [--scans N] [--link-bytes-per-s N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<ScanFrame> scans = makeScans(scanCount);
+  size_t samples = 0;
+  for (const ScanFrame& f : scans) samples += f.count;
+
+  {
+    TelemetryStream stream;
+    Capture out;
+    stream.setOutput(&out);
+    stream.setMode(TELEMETRY_TEXT);
+    auto start = std::chrono::steady_clock::now();
+    for (const ScanFrame& f : scans) stream.send(f);
+    report("text", 0, samples, out.data.size(), secondsSince(start), 0);
+  }
+
+  const int packs[] = {1, 4, 16};
+  for (int pack : packs) {
+    TelemetryStream stream;
+    Capture out;
+    stream.setOutput(&out);
+    stream.setMode(TELEMETRY_BINARY, pack);
+    auto start = std::chrono::steady_clock::now();
+    for (const ScanFrame& f : scans) stream.send(f);
+    stream.flush();
+    double encodeS = secondsSince(start);
+
+    Collected got;
+    got.samples.reserve(samples);
+    TelemetryDecoder decoder;
+    start = std::chrono::steady_clock::now();
+    decoder.feed(out.data.data(), out.data.size(), collect, &got);
+    double decodeS = secondsSince(start);
+
+    char what[64];
+    snprintf(what, sizeof(what), "pack %d: decoded samples differ from the input", pack);
+    check(matches(got.samples, scans), what);
+    check(decoder.getStats().badFrames == 0 && decoder.getStats().sequenceGaps == 0,
+          "clean stream reported errors");
+    snprintf(what, sizeof(what), "pack %d: scans split across frames", pack);
+    check(wholeScans(out.data, scans[0].count), what);
+    report("binary", pack, samples, out.data.size(), encodeS, decodeS);
+    if (pack == 4) checkDamage(out.data, scans);
+  }
+
+  return checkResult(true);
+}
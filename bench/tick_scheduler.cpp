@@ -0,0 +1,152 @@
+/*
+ * Host check for synchronized acquisition ticks
+ * Drives TickScheduler with simulated wake latencies and overruns across
+ * the 32-bit microsecond rollover and checks every tick stays on its grid,
+ * compares the drift against sleep-after-work pacing, then runs a live
+ * synchronized AcquisitionTask and prints its latency and skew.
+ *
+ * Build: g++ -O2 -std=gnu++17 -pthread -Isim -Iinclude bench/tick_scheduler.cpp
+ *        sim/SimHardware.cpp -o tick_scheduler
+ */
+
+#include <stdio.h>
+#include <vector>
+#include "Acquisition.h"
+#include "check.h"
+
+static uint32_t nextRandom(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+// Late wakes of up to 300 us never move a tick
+static void checkGrid() {
+  const uint32_t period = 1000;
+  const uint32_t origin = 0xFFFFFFFFu - 50000000u;  // Rolls over after 50 s
+  TickScheduler ticks;
+  ticks.start(period, origin);
+  uint32_t state = 1;
+  bool onGrid = true;
+  uint32_t now = origin;
+  for (uint32_t n = 0; n < 1000000; n++) {
+    now = origin + n * period + nextRandom(state) % 300;
+    uint32_t tickUs;
+    if (!ticks.take(now, tickUs) || tickUs != origin + n * period) onGrid = false;
+  }
+  check(onGrid, "grid: a tick moved");
+  check(ticks.getStats().missed == 0, "grid: late wakes counted as missed");
+  printf("grid: 1000000 ticks over the rollover, last tick %u us after the grid origin\n",
+         (unsigned)(now - origin));
+}
+
+// A scan running past ticks drops them and the grid continues
+static void checkOverrun() {
+  TickScheduler ticks;
+  ticks.start(1000, 0);
+  uint32_t tickUs;
+  check(ticks.take(0, tickUs) && tickUs == 0, "overrun: first tick");
+  check(!ticks.take(400, tickUs), "overrun: tick served early");
+  check(ticks.take(600, tickUs) && tickUs == 1000, "overrun: timer a bit early");
+  check(ticks.take(3500, tickUs) && tickUs == 3000, "overrun: wrong tick after overrun");
+  check(ticks.getStats().missed == 1, "overrun: missed tick not counted");
+  check(ticks.take(4010, tickUs) && tickUs == 4000, "overrun: grid lost");
+  check(ticks.untilNextUs(4500) == 500, "overrun: time to next tick");
+}
+
+static void checkScanStats() {
+  TickScheduler ticks;
+  ticks.start(1000, 0);
+  ScanFrame frame;
+  uint32_t tickUs;
+  ticks.take(0, tickUs);
+  frame.readStartUs = 12;
+  frame.alignedEndUs = 15;
+  frame.readEndUs = 410;
+  ticks.recordScan(tickUs, frame);
+  ticks.take(1000, tickUs);
+  frame.readStartUs = 1008;
+  frame.alignedEndUs = 1020;
+  frame.readEndUs = 1300;
+  ticks.recordScan(tickUs, frame);
+  const TickStats& s = ticks.getStats();
+  check(s.ticks == 2 && s.minLatencyUs == 8 && s.maxLatencyUs == 12 && s.latencySumUs == 20,
+        "stats: latency");
+  check(s.maxSkewUs == 398 && s.lastSkewUs == 292, "stats: skew");
+  check(s.maxAlignedSkewUs == 12 && s.lastAlignedSkewUs == 12, "stats: aligned skew");
+}
+
+// Sleeping a period after each scan adds the scan time every cycle
+static void comparePacing() {
+  const uint32_t period = 1000;
+  const int scans = 10000;
+  uint32_t state = 5;
+  uint32_t sleepNow = 0;
+  TickScheduler ticks;
+  ticks.start(period, 0);
+  uint32_t tickNow = 0;
+  for (int i = 0; i < scans; i++) {
+    uint32_t work = 150 + nextRandom(state) % 100;  // Scan plus printing
+    sleepNow += work + period;
+    uint32_t tickUs = tickNow;
+    ticks.take(tickNow, tickUs);
+    tickNow = tickUs + work;
+    tickNow += ticks.untilNextUs(tickNow);
+  }
+  double sleepDrift = sleepNow - (double)scans * period;
+  double tickDrift = tickNow - (double)scans * period;
+  check(tickDrift == 0, "pacing: ticks drifted");
+  printf("pacing: after %d scans, sleep-after-work is %.1f ms behind, ticks %.1f ms\n", scans,
+         sleepDrift / 1000, tickDrift / 1000);
+}
+
+// ========== LIVE ==========
+
+static size_t fakeScan(ScanFrame& frame, void* context) {
+  (void)context;
+  frame.readStartUs = micros();
+  frame.alignedEndUs = frame.readStartUs;
+  for (size_t i = 0; i < 4; i++) {
+    frame.timestampUs[i] = micros();
+    frame.channel[i] = i;
+    frame.value[i] = i;
+    frame.status[i] = SAMPLE_OK;
+    frame.sub[i] = 0;
+    if (i == 1) frame.alignedEndUs = frame.timestampUs[i];
+  }
+  frame.readEndUs = micros();
+  frame.count = 4;
+  return 4;
+}
+
+static void runLive() {
+  AcquisitionTask task;
+  const uint32_t period = 1000;
+  uint32_t start = micros();
+  check(task.startSynchronized(fakeScan, nullptr, 4, 8192, period), "live: start failed");
+  Sample drained[256];
+  while (micros() - start < 1000000) {
+    task.drain(drained, 256);
+    delay(5);
+  }
+  task.stop();
+  uint32_t elapsed = micros() - start;
+  TickStats s = task.getTickStats();
+  uint32_t expected = elapsed / period;
+  check(s.ticks + s.missed + 2 >= expected && s.ticks + s.missed <= expected + 1,
+        "live: ticks don't match elapsed time");
+  printf("live: %u ticks, %u missed in %.3f s; latency min %u / mean %.1f / max %u us, "
+         "skew max %u us\n",
+         (unsigned)s.ticks, (unsigned)s.missed, elapsed / 1e6, (unsigned)s.minLatencyUs,
+         s.ticks ? (double)s.latencySumUs / s.ticks : 0.0, (unsigned)s.maxLatencyUs,
+         (unsigned)s.maxSkewUs);
+}
+
+int main() {
+  checkGrid();
+  checkOverrun();
+  checkScanStats();
+  comparePacing();
+  runLive();
+
+  return checkResult();
+}
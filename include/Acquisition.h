@@ -0,0 +1,339 @@
+/*
+ * Dedicated acquisition task
+ * Runs scans on one core (FreeRTOS task pinned with xTaskCreatePinnedToCore)
+ * and pushes every sample into an SpscRing drained from the other core.
+ * Scans run at a fixed period, or with a DelayCallback the task sleeps
+ * until the next deadline it reports, or synchronized to a hardware timer
+ * (esp_timer) with ticks from a TickScheduler. On the host the same loop
+ * runs on a std::thread.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include "SampleRing.h"
+#include "ScanPlan.h"
+#include "TickScheduler.h"
+
+#if defined(ESP32)
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#else
+#include <chrono>
+#include <mutex>
+#include <thread>
+#endif
+
+// Fills the frame with one scan, returns samples written
+typedef size_t (*ScanCallback)(ScanFrame& frame, void* context);
+
+// Microseconds until the next scan is due
+typedef uint32_t (*DelayCallback)(void* context);
+
+// Held for a whole scan, and by anything that rebuilds the tables a scan
+// reads, so a config change from loop() waits for the scan running on the
+// other core instead of freeing its plan mid-scan. Recursive: a rebuild
+// may run inside another locked change.
+class ScanMutex {
+private:
+#if defined(ESP32)
+  SemaphoreHandle_t mutex = nullptr;
+#else
+  std::recursive_mutex mutex;
+#endif
+
+public:
+  ScanMutex() {
+#if defined(ESP32)
+    mutex = xSemaphoreCreateRecursiveMutex();
+#endif
+  }
+
+  void lock() {
+#if defined(ESP32)
+    xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+#else
+    mutex.lock();
+#endif
+  }
+
+  void unlock() {
+#if defined(ESP32)
+    xSemaphoreGiveRecursive(mutex);
+#else
+    mutex.unlock();
+#endif
+  }
+};
+
+class ScanLock {
+private:
+  ScanMutex& mutex;
+
+public:
+  explicit ScanLock(ScanMutex& m) : mutex(m) {
+    mutex.lock();
+  }
+
+  ~ScanLock() {
+    mutex.unlock();
+  }
+
+  ScanLock(const ScanLock&) = delete;
+  ScanLock& operator=(const ScanLock&) = delete;
+};
+
+class AcquisitionTask {
+private:
+  SpscRing<Sample> ring;
+  ScanFrame frame;
+  ScanCallback scan = nullptr;
+  DelayCallback nextDelay = nullptr;  // Set: sleep until the next deadline
+  void* context = nullptr;
+  uint32_t periodMs = 0;
+  bool synchronized = false;  // Scans on timer ticks
+  TickScheduler ticks;
+  std::atomic<bool> running{false};
+  std::atomic<uint32_t> scans{0};
+
+#if defined(ESP32)
+  TaskHandle_t handle = nullptr;
+  esp_timer_handle_t timer = nullptr;
+  std::atomic<bool> exited{true};
+#else
+  std::thread worker;
+#endif
+
+  void runOnce() {
+    size_t n = scan(frame, context);
+    for (size_t i = 0; i < n; i++) {
+      Sample s;
+      s.timestampUs = frame.timestampUs[i];
+      s.channel = frame.channel[i];
+      s.status = frame.status[i];
+      s.sub = frame.sub[i];
+      s.value = frame.value[i];
+      ring.push(s);  // Full ring counts an overrun, never blocks
+    }
+    scans.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // One tick of synchronized mode, if due
+  void runTick(uint32_t nowUs) {
+    uint32_t tickUs;
+    if (!ticks.take(nowUs, tickUs)) return;
+    runOnce();
+    ticks.recordScan(tickUs, frame);
+  }
+
+#if defined(ESP32)
+  // esp_timer task context: hand the tick to the acquisition task
+  static void timerEntry(void* arg) {
+    AcquisitionTask* self = (AcquisitionTask*)arg;
+    if (self->handle) xTaskNotifyGive(self->handle);
+  }
+
+  static void taskEntry(void* arg) {
+    AcquisitionTask* self = (AcquisitionTask*)arg;
+    TickType_t lastWake = xTaskGetTickCount();
+    TickType_t period = pdMS_TO_TICKS(self->periodMs);
+    while (self->running.load()) {
+      if (self->synchronized) {
+        // Bounded wait so stop() is noticed without a tick
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(50)) > 0) self->runTick(micros());
+        continue;
+      }
+      self->runOnce();
+      if (self->nextDelay) {
+        // Whole ticks, rounded up so the deadline has passed on wake
+        uint32_t us = self->nextDelay(self->context);
+        if (us > 0) {
+          vTaskDelay(std::max<TickType_t>(1, pdMS_TO_TICKS((us + 999) / 1000)));
+        } else {
+          taskYIELD();
+        }
+      } else if (period > 0) {
+        vTaskDelayUntil(&lastWake, period);
+      } else {
+        taskYIELD();
+      }
+    }
+    self->exited.store(true);
+    vTaskDelete(nullptr);
+  }
+#else
+  void threadLoop() {
+    auto next = std::chrono::steady_clock::now();
+    while (running.load()) {
+      if (synchronized) {
+        // No hardware timer: sleep to the tick, then spin the last stretch
+        uint32_t wait = ticks.untilNextUs(micros());
+        if (wait > 200) std::this_thread::sleep_for(std::chrono::microseconds(wait - 200));
+        while (ticks.untilNextUs(micros()) > 0) {
+        }
+        runTick(micros());
+        continue;
+      }
+      runOnce();
+      if (nextDelay) {
+        uint32_t us = nextDelay(context);
+        if (us > 0) {
+          std::this_thread::sleep_for(std::chrono::microseconds(us));
+        } else {
+          std::this_thread::yield();
+        }
+      } else if (periodMs > 0) {
+        next += std::chrono::milliseconds(periodMs);
+        std::this_thread::sleep_until(next);
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+#endif
+
+  bool launch(int core, int priority) {
+    scans.store(0);
+    running.store(true);
+
+#if defined(ESP32)
+    exited.store(false);
+    if (xTaskCreatePinnedToCore(taskEntry, "acquisition", 4096, this, priority,
+                                &handle, core) != pdPASS) {
+      running.store(false);
+      exited.store(true);
+      return false;
+    }
+    if (synchronized) {
+      // Periodic alarms are computed from the previous alarm, not from
+      // when the callback ran, so the timer itself doesn't drift
+      esp_timer_create_args_t args = {};
+      args.callback = timerEntry;
+      args.arg = this;
+      args.name = "acq_tick";
+      uint32_t period = ticks.getPeriodUs();
+      if (esp_timer_create(&args, &timer) != ESP_OK) {
+        stop();
+        return false;
+      }
+      ticks.start(period, micros() + period);
+      if (esp_timer_start_periodic(timer, period) != ESP_OK) {
+        stop();
+        return false;
+      }
+    }
+#else
+    (void)core;
+    (void)priority;
+    worker = std::thread(&AcquisitionTask::threadLoop, this);
+#endif
+    return true;
+  }
+
+public:
+  ~AcquisitionTask() {
+    stop();
+  }
+
+  // Start scanning every periodMs (0 = back-to-back).
+  // frameSize is the samples per scan; ringSize the samples buffered.
+  bool start(ScanCallback callback, void* ctx, size_t frameSize, size_t ringSize,
+             uint32_t period, int core = 0, int priority = 5) {
+    if (running.load()) return false;
+    if (!ring.begin(ringSize)) return false;
+    frame.reserve(frameSize);
+    scan = callback;
+    nextDelay = nullptr;
+    context = ctx;
+    periodMs = period;
+    synchronized = false;
+    return launch(core, priority);
+  }
+
+  // Start scanning whenever delay() says the next scan is due
+  bool startScheduled(ScanCallback callback, DelayCallback delay, void* ctx, size_t frameSize,
+                      size_t ringSize, int core = 0, int priority = 5) {
+    if (running.load()) return false;
+    if (!ring.begin(ringSize)) return false;
+    frame.reserve(frameSize);
+    scan = callback;
+    nextDelay = delay;
+    context = ctx;
+    periodMs = 0;
+    synchronized = false;
+    return launch(core, priority);
+  }
+
+  // Start a scan on every tick of a hardware timer, every periodUs.
+  // Each scan starts on a fixed grid; see getTickStats() for latency,
+  // skew and missed ticks.
+  bool startSynchronized(ScanCallback callback, void* ctx, size_t frameSize, size_t ringSize,
+                         uint32_t periodUs, int core = 0, int priority = 10) {
+    if (running.load()) return false;
+    if (!ring.begin(ringSize)) return false;
+    frame.reserve(frameSize);
+    scan = callback;
+    nextDelay = nullptr;
+    context = ctx;
+    periodMs = 0;
+    synchronized = true;
+    ticks.start(periodUs, micros());  // Restarted on the timer's grid on the ESP32
+    return launch(core, priority);
+  }
+
+  // Stop after the current scan completes
+  void stop() {
+    if (!running.exchange(false)) return;
+#if defined(ESP32)
+    if (timer) {
+      esp_timer_stop(timer);
+      esp_timer_delete(timer);
+      timer = nullptr;
+    }
+    while (!exited.load()) vTaskDelay(1);
+    handle = nullptr;
+#else
+    if (worker.joinable()) worker.join();
+#endif
+  }
+
+  bool isRunning() const {
+    return running.load();
+  }
+
+  // Consumer API, call from one task/core only
+  size_t drain(Sample* out, size_t max) {
+    return ring.drain(out, max);
+  }
+
+  size_t pending() const {
+    return ring.size();
+  }
+
+  uint32_t scanCount() const {
+    return scans.load(std::memory_order_relaxed);
+  }
+
+  uint32_t overrunCount() const {
+    return ring.overrunCount();
+  }
+
+  uint32_t underrunCount() const {
+    return ring.underrunCount();
+  }
+
+  void resetCounters() {
+    ring.resetCounters();
+    ticks.resetStats();
+  }
+
+  // Synchronized mode: tick latency, scan skew and missed ticks
+  const TickStats& getTickStats() const {
+    return ticks.getStats();
+  }
+};
@@ -0,0 +1,186 @@
+/*
+ * Continuous ADC frame demux and filters
+ * The ESP32-S3 ADC in continuous mode DMAs 4-byte results (TYPE2 format:
+ * 12-bit data, channel, unit) for its whole conversion pattern into one
+ * buffer. AdcDemux routes each result to its channel, converts it to
+ * millivolts through a calibration lookup table, averages `oversample`
+ * conversions into one value and optionally smooths those values with an
+ * exponential filter. No hardware or Arduino dependency, so synthetic
+ * frames can be fed on the host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+
+#define ADC_RAW_MAX 4095           // 12-bit results
+#define ADC_RESULT_BYTES 4         // One TYPE2 result
+#define ADC_MAX_CHANNELS 10        // ADC1 channels on the ESP32-S3
+#define ADC_DEFAULT_FULL_SCALE_MV 3100  // Uncalibrated 11 dB range
+
+// TYPE2 result word: data [11:0], channel [16:13], unit [17]
+inline uint32_t adcEncodeResult(uint8_t unit, uint8_t channel, uint16_t raw) {
+  return (raw & 0xFFF) | ((uint32_t)(channel & 0xF) << 13) | ((uint32_t)(unit & 1) << 17);
+}
+
+inline uint16_t adcResultData(uint32_t word) {
+  return word & 0xFFF;
+}
+
+inline uint8_t adcResultChannel(uint32_t word) {
+  return (word >> 13) & 0xF;
+}
+
+inline uint8_t adcResultUnit(uint32_t word) {
+  return (word >> 17) & 1;
+}
+
+// Raw code to millivolts, precomputed for every code
+class AdcCalibration {
+private:
+  uint16_t mv[ADC_RAW_MAX + 1];
+
+public:
+  AdcCalibration() {
+    buildLinear(ADC_DEFAULT_FULL_SCALE_MV);
+  }
+
+  // Straight line from 0 to fullScaleMv, used when there is no eFuse data
+  void buildLinear(uint16_t fullScaleMv) {
+    for (uint32_t raw = 0; raw <= ADC_RAW_MAX; raw++) {
+      mv[raw] = (uint16_t)((raw * fullScaleMv + ADC_RAW_MAX / 2) / ADC_RAW_MAX);
+    }
+  }
+
+  // Fill entry by entry, e.g. from the chip's calibration curve
+  void set(uint16_t raw, uint16_t millivolts) {
+    if (raw <= ADC_RAW_MAX) mv[raw] = millivolts;
+  }
+
+  uint16_t toMv(uint16_t raw) const {
+    return mv[raw & ADC_RAW_MAX];
+  }
+};
+
+// Per-channel oversampling and smoothing state
+struct AdcChannelFilter {
+  uint32_t accMv;               // Sum of the current block
+  uint16_t count;               // Conversions in the current block
+  float smoothed;               // Exponential filter state
+  std::atomic<float> latest;    // Published value, read by other tasks
+  std::atomic<uint32_t> blocks; // Values published so far
+};
+
+class AdcDemux {
+private:
+  AdcChannelFilter filters[ADC_MAX_CHANNELS];
+  int8_t slotOf[16];            // ADC1 channel -> filter slot, -1 = not ours
+  uint8_t slotCount = 0;
+  uint16_t oversample = 1;      // Conversions per published value
+  uint8_t smoothingShift = 0;   // Filter weight 1/2^shift, 0 = off
+  const AdcCalibration* calibration = nullptr;
+  uint32_t conversions = 0;
+  uint32_t foreign = 0;         // Results for other units/channels, dropped
+
+  void accept(AdcChannelFilter& f, uint16_t raw) {
+    f.accMv += calibration->toMv(raw);
+    if (++f.count < oversample) return;
+
+    float mean = (float)f.accMv / f.count;
+    f.accMv = 0;
+    f.count = 0;
+    uint32_t n = f.blocks.load(std::memory_order_relaxed);
+    if (smoothingShift == 0 || n == 0) {
+      f.smoothed = mean;
+    } else {
+      f.smoothed += (mean - f.smoothed) / (float)(1u << smoothingShift);
+    }
+    f.latest.store(f.smoothed, std::memory_order_relaxed);
+    f.blocks.store(n + 1, std::memory_order_release);
+  }
+
+public:
+  AdcDemux() {
+    configure(nullptr, 0, 1, 0, nullptr);
+  }
+
+  // channels[i] is the ADC1 channel of slot i. Clears all filter state.
+  void configure(const uint8_t* channels, uint8_t count, uint16_t oversampleCount,
+                 uint8_t smoothing, const AdcCalibration* cal) {
+    memset(slotOf, -1, sizeof(slotOf));
+    slotCount = count < ADC_MAX_CHANNELS ? count : ADC_MAX_CHANNELS;
+    for (uint8_t i = 0; i < slotCount; i++) slotOf[channels[i] & 0xF] = i;
+    oversample = oversampleCount ? oversampleCount : 1;
+    smoothingShift = smoothing < 15 ? smoothing : 15;
+    calibration = cal;
+    reset();
+  }
+
+  void reset() {
+    for (auto& f : filters) {
+      f.accMv = 0;
+      f.count = 0;
+      f.smoothed = 0;
+      f.latest.store(0, std::memory_order_relaxed);
+      f.blocks.store(0, std::memory_order_relaxed);
+    }
+    conversions = 0;
+    foreign = 0;
+  }
+
+  // Demux a DMA buffer of TYPE2 results. Trailing partial results are
+  // ignored. Returns the number of results used.
+  size_t feed(const uint8_t* data, size_t len) {
+    size_t used = 0;
+    for (size_t off = 0; off + ADC_RESULT_BYTES <= len; off += ADC_RESULT_BYTES) {
+      uint32_t word;
+      memcpy(&word, data + off, sizeof(word));
+      int8_t slot = adcResultUnit(word) == 0 ? slotOf[adcResultChannel(word)] : -1;
+      if (slot < 0 || !calibration) {
+        foreign++;
+        continue;
+      }
+      accept(filters[slot], adcResultData(word));
+      used++;
+    }
+    conversions += used;
+    return used;
+  }
+
+  // Latest filtered millivolts of a slot; false until its first block
+  bool latest(uint8_t slot, float& mv) const {
+    if (slot >= slotCount) return false;
+    const AdcChannelFilter& f = filters[slot];
+    if (f.blocks.load(std::memory_order_acquire) == 0) return false;
+    mv = f.latest.load(std::memory_order_relaxed);
+    return true;
+  }
+
+  // Filter slot fed by an ADC1 channel, -1 if it isn't in the pattern
+  int8_t slotForChannel(uint8_t channel) const {
+    return channel < 16 ? slotOf[channel] : -1;
+  }
+
+  uint32_t blockCount(uint8_t slot) const {
+    return slot < slotCount ? filters[slot].blocks.load(std::memory_order_relaxed) : 0;
+  }
+
+  uint8_t size() const {
+    return slotCount;
+  }
+
+  uint16_t getOversample() const {
+    return oversample;
+  }
+
+  uint32_t conversionCount() const {
+    return conversions;
+  }
+
+  uint32_t foreignCount() const {
+    return foreign;
+  }
+};
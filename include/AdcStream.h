@@ -0,0 +1,307 @@
+/*
+ * Continuous ADC acquisition for ANALOG channels
+ * Runs ADC1 in DMA-driven continuous mode over every streamed pin and
+ * feeds the DMA frames through AdcDemux from a small reader task, so reads
+ * return the latest filtered millivolts without touching the ADC. Uses the
+ * adc_continuous driver on ESP-IDF 5 and adc_digi on ESP-IDF 4. On the
+ * host a thread synthesizes frames from the simulated pin values.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include "AdcFrames.h"
+#include "ScanPlan.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_idf_version.h>
+#if ESP_IDF_VERSION_MAJOR >= 5
+#include <esp_adc/adc_continuous.h>
+#include <esp_adc/adc_cali.h>
+#include <esp_adc/adc_cali_scheme.h>
+#else
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+#endif
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+#define ADC_STREAM_MIN_HZ 611          // Whole-pattern conversion rate limits
+#define ADC_STREAM_MAX_HZ 83333
+#define ADC_STREAM_FRAME_BYTES 256     // Results handed to the reader per DMA frame
+#define ADC_STREAM_BUFFER_BYTES 2048   // Driver pool between DMA and the reader
+#define ADC_STREAM_ATTEN 3             // 11/12 dB, about 0-3.1 V
+
+// ESP32-S3: GPIO1..GPIO10 are ADC1 channels 0..9, -1 for other pins
+inline int adc1ChannelForPin(int pin) {
+  return pin >= 1 && pin <= 10 ? pin - 1 : -1;
+}
+
+class AdcStream {
+private:
+  AdcDemux demux;
+  AdcCalibration calibration;
+  bool calibrated = false;
+  uint8_t pins[ADC_MAX_CHANNELS];
+  uint8_t pinCount = 0;
+  uint32_t rateHz = 0;           // Conversions per second per pin
+  uint16_t oversample = 0;
+  uint8_t smoothing = 0;
+  std::atomic<bool> running{false};
+
+#if defined(ESP32)
+  TaskHandle_t handle = nullptr;
+  std::atomic<bool> exited{true};
+#if ESP_IDF_VERSION_MAJOR >= 5
+  adc_continuous_handle_t adc = nullptr;
+#endif
+
+  // Replace the linear table with the chip's eFuse calibration
+  void calibrate() {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    adc_cali_curve_fitting_config_t cfg = {};
+    cfg.unit_id = ADC_UNIT_1;
+    cfg.atten = (adc_atten_t)ADC_STREAM_ATTEN;
+    cfg.bitwidth = ADC_BITWIDTH_12;
+    adc_cali_handle_t cali;
+    if (adc_cali_create_scheme_curve_fitting(&cfg, &cali) != ESP_OK) return;
+    for (uint16_t raw = 0; raw <= ADC_RAW_MAX; raw++) {
+      int mv = 0;
+      adc_cali_raw_to_voltage(cali, raw, &mv);
+      calibration.set(raw, mv);
+    }
+    adc_cali_delete_scheme_curve_fitting(cali);
+#else
+    esp_adc_cal_characteristics_t chars;
+    esp_adc_cal_characterize(ADC_UNIT_1, (adc_atten_t)ADC_STREAM_ATTEN, ADC_WIDTH_BIT_12,
+                             1100, &chars);
+    for (uint16_t raw = 0; raw <= ADC_RAW_MAX; raw++) {
+      calibration.set(raw, esp_adc_cal_raw_to_voltage(raw, &chars));
+    }
+#endif
+  }
+
+  bool startDriver(uint32_t patternHz) {
+    adc_digi_pattern_config_t pattern[ADC_MAX_CHANNELS] = {};
+    for (uint8_t i = 0; i < pinCount; i++) {
+      pattern[i].atten = ADC_STREAM_ATTEN;
+      pattern[i].channel = adc1ChannelForPin(pins[i]);
+      pattern[i].unit = 0;  // ADC1
+      pattern[i].bit_width = 12;
+    }
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+    adc_continuous_handle_cfg_t handleCfg = {};
+    handleCfg.max_store_buf_size = ADC_STREAM_BUFFER_BYTES;
+    handleCfg.conv_frame_size = ADC_STREAM_FRAME_BYTES;
+    if (adc_continuous_new_handle(&handleCfg, &adc) != ESP_OK) return false;
+
+    adc_continuous_config_t cfg = {};
+    cfg.pattern_num = pinCount;
+    cfg.adc_pattern = pattern;
+    cfg.sample_freq_hz = patternHz;
+    cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_continuous_config(adc, &cfg) != ESP_OK || adc_continuous_start(adc) != ESP_OK) {
+      adc_continuous_deinit(adc);
+      adc = nullptr;
+      return false;
+    }
+#else
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = ADC_STREAM_BUFFER_BYTES;
+    init.conv_num_each_intr = ADC_STREAM_FRAME_BYTES;
+    for (uint8_t i = 0; i < pinCount; i++) init.adc1_chan_mask |= 1u << pattern[i].channel;
+    if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+    adc_digi_configuration_t cfg = {};
+    cfg.pattern_num = pinCount;
+    cfg.adc_pattern = pattern;
+    cfg.sample_freq_hz = patternHz;
+    cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_digi_controller_configure(&cfg) != ESP_OK || adc_digi_start() != ESP_OK) {
+      adc_digi_deinitialize();
+      return false;
+    }
+#endif
+    return true;
+  }
+
+  void stopDriver() {
+#if ESP_IDF_VERSION_MAJOR >= 5
+    adc_continuous_stop(adc);
+    adc_continuous_deinit(adc);
+    adc = nullptr;
+#else
+    adc_digi_stop();
+    adc_digi_deinitialize();
+#endif
+  }
+
+  // Blocks until the next DMA frame (or a short timeout), never polls
+  size_t readFrame(uint8_t* buf, size_t len) {
+    uint32_t got = 0;
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_err_t err = adc_continuous_read(adc, buf, len, &got, 20);
+#else
+    esp_err_t err = adc_digi_read_bytes(buf, len, &got, pdMS_TO_TICKS(20));
+    if (err == ESP_ERR_INVALID_STATE) err = ESP_OK;  // Pool overflowed, data is still valid
+#endif
+    return err == ESP_OK ? got : 0;
+  }
+
+  static void taskEntry(void* arg) {
+    AdcStream* self = (AdcStream*)arg;
+    uint8_t buf[ADC_STREAM_FRAME_BYTES];
+    while (self->running.load()) {
+      size_t n = self->readFrame(buf, sizeof(buf));
+      if (n > 0) self->demux.feed(buf, n);
+    }
+    self->exited.store(true);
+    vTaskDelete(nullptr);
+  }
+#else
+  std::thread worker;
+
+  void calibrate() {}
+
+  bool startDriver(uint32_t patternHz) {
+    (void)patternHz;
+    return true;
+  }
+
+  void stopDriver() {}
+
+  // Simulated DMA: the current pin values at the configured rate
+  void threadLoop() {
+    uint8_t buf[ADC_STREAM_FRAME_BYTES];
+    size_t perFrame = sizeof(buf) / ADC_RESULT_BYTES;
+    uint64_t produced = 0;
+    size_t next = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (running.load()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      uint64_t due = (uint64_t)(elapsed * rateHz * pinCount);
+      while (produced < due && running.load()) {
+        size_t n = (size_t)std::min<uint64_t>(due - produced, perFrame);
+        for (size_t i = 0; i < n; i++) {
+          uint8_t pin = pins[next];
+          uint32_t word = adcEncodeResult(0, adc1ChannelForPin(pin), Sim.analogValue(pin));
+          memcpy(buf + i * ADC_RESULT_BYTES, &word, sizeof(word));
+          next = (next + 1) % pinCount;
+        }
+        demux.feed(buf, n * ADC_RESULT_BYTES);
+        produced += n;
+      }
+    }
+  }
+#endif
+
+public:
+  ~AdcStream() {
+    end();
+  }
+
+  // Stream these pins (ADC1-capable ones only) at hz conversions per pin,
+  // averaging oversampleCount conversions per value. No-op if already
+  // running with the same settings. Returns false if nothing was started.
+  bool begin(const uint8_t* pinList, uint8_t count, uint32_t hz, uint16_t oversampleCount,
+             uint8_t smoothingShift) {
+    uint8_t usable[ADC_MAX_CHANNELS];
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < count && n < ADC_MAX_CHANNELS; i++) {
+      if (adc1ChannelForPin(pinList[i]) >= 0) usable[n++] = pinList[i];
+    }
+
+    if (running.load() && n == pinCount && hz == rateHz && oversampleCount == oversample &&
+        smoothingShift == smoothing && memcmp(usable, pins, n) == 0) {
+      return true;
+    }
+    end();
+    if (n == 0 || hz == 0) return false;
+
+    memcpy(pins, usable, n);
+    pinCount = n;
+    rateHz = hz;
+    oversample = oversampleCount;
+    smoothing = smoothingShift;
+
+    uint8_t channels[ADC_MAX_CHANNELS];
+    for (uint8_t i = 0; i < n; i++) channels[i] = adc1ChannelForPin(pins[i]);
+    if (!calibrated) {
+      calibrate();
+      calibrated = true;
+    }
+    demux.configure(channels, n, oversample, smoothing, &calibration);
+
+    uint32_t patternHz = constrain(hz * n, (uint32_t)ADC_STREAM_MIN_HZ, (uint32_t)ADC_STREAM_MAX_HZ);
+    if (!startDriver(patternHz)) {
+      pinCount = 0;
+      return false;
+    }
+
+    running.store(true);
+#if defined(ESP32)
+    exited.store(false);
+    if (xTaskCreatePinnedToCore(taskEntry, "adc_stream", 3072, this, 6, &handle, 0) != pdPASS) {
+      running.store(false);
+      exited.store(true);
+      stopDriver();
+      pinCount = 0;
+      return false;
+    }
+#else
+    worker = std::thread(&AdcStream::threadLoop, this);
+#endif
+    return true;
+  }
+
+  void end() {
+    if (!running.exchange(false)) return;
+#if defined(ESP32)
+    while (!exited.load()) vTaskDelay(1);
+    handle = nullptr;
+#else
+    if (worker.joinable()) worker.join();
+#endif
+    stopDriver();
+    pinCount = 0;
+  }
+
+  bool isRunning() const {
+    return running.load();
+  }
+
+  // True if reads of this pin come from the stream
+  bool streams(int pin) const {
+    int ch = adc1ChannelForPin(pin);
+    return running.load() && ch >= 0 && demux.slotForChannel(ch) >= 0;
+  }
+
+  // Latest filtered millivolts, SAMPLE_NOT_READY until the first block
+  SampleStatus read(int pin, float& mv) const {
+    int8_t slot = demux.slotForChannel(adc1ChannelForPin(pin));
+    if (slot < 0) return SAMPLE_ERROR;
+    return demux.latest(slot, mv) ? SAMPLE_OK : SAMPLE_NOT_READY;
+  }
+
+  uint32_t getRateHz() const {
+    return rateHz;
+  }
+
+  uint8_t pinCountStreamed() const {
+    return pinCount;
+  }
+
+  const AdcDemux& getDemux() const {
+    return demux;
+  }
+};
@@ -0,0 +1,307 @@
+/*
+ * Compile-time board profiles
+ * A board built for one known wiring can describe its fixed channels as a
+ * type instead of pushing FixedChannels at runtime:
+ *
+ *   typedef BoardProfile<DigitalPin<1, 2>, AnalogPin<2, 4>, OneWirePin<3, 5>,
+ *                        SpiPin<5, 14, 1000000, 0, 0x03, 2>> MyBoard;
+ *
+ * Define it before ConfigLib.ino is included (or add it below) and build
+ * with -DBOARD_PROFILE=MyBoard. Pin setup and the fixed-channel part of
+ * scanAll() are then generated per channel: pins, GPIO register bits and
+ * SPI settings are constants, there is no switch on the channel type and
+ * the bus order is resolved by the compiler. I2C channels stay runtime
+ * channels configured from JSON.
+ * Channels are listed in ascending channel order (checked at compile time),
+ * so the generated scan writes the same frame layout as the scan plan.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <vector>
+#include "GpioSnapshot.h"
+#include "ReadStats.h"
+#include "ScanPlan.h"
+
+// A profile channel as data, for building the runtime FixedChannels
+struct ProfileChannel {
+  int16_t channel;
+  int16_t pin;
+  ChannelType type;
+  uint8_t sensor;
+  uint8_t spiMode;
+  uint8_t spiCommand;
+  uint8_t spiLength;
+  uint32_t spiClockHz;
+};
+
+// ========== CHANNEL DESCRIPTORS ==========
+
+template <int Channel, int Pin, ChannelType Type, uint8_t Sensor = 0, uint32_t ClockHz = 0,
+          uint8_t Mode = 0, uint8_t Command = 0, uint8_t Length = 0>
+struct ProfilePin {
+  static_assert(Channel >= 0 && Channel < 32768, "channel number out of range");
+  static_assert(Pin >= 0 && Pin < 32 * GPIO_BANKS, "not a GPIO pin");
+  static_assert(Type != CH_NONE && Type != CH_I2C, "I2C channels are configured at runtime");
+
+  static constexpr int channel = Channel;
+  static constexpr int pin = Pin;
+  static constexpr ChannelType type = Type;
+  static constexpr ScanBus bus = Type == CH_ANALOG  ? BUS_ADC
+                               : Type == CH_ONEWIRE ? BUS_ONEWIRE
+                               : Type == CH_SPI     ? BUS_SPI
+                                                    : BUS_GPIO;
+
+  static constexpr ProfileChannel describe() {
+    return ProfileChannel{(int16_t)Channel, (int16_t)Pin, Type,    Sensor,
+                          Mode,             Command,      Length, ClockHz};
+  }
+
+  // Same pin modes as ConfigManager::setupPin()
+  static void setup() {
+    if (Type == CH_SPI) {
+      pinMode(Pin, OUTPUT);
+      digitalWrite(Pin, HIGH);  // CS pin HIGH (inactive)
+    } else {
+      pinMode(Pin, INPUT);
+    }
+  }
+};
+
+// Reads call back into the Reader (ConfigManager) for the bus objects it
+// owns; at is the channel's position in the scan plan.
+
+template <int Channel, int Pin>
+struct DigitalPin : ProfilePin<Channel, Pin, CH_DIGITAL> {
+  template <class Reader>
+  static SampleStatus read(Reader&, uint16_t, const GpioSnapshot& gpio, float& value) {
+    value = (gpio.in[(Pin >> 5) & (GPIO_BANKS - 1)] >> (Pin & 31)) & 1;
+    return SAMPLE_OK;
+  }
+};
+
+template <int Channel, int Pin>
+struct AnalogPin : ProfilePin<Channel, Pin, CH_ANALOG> {
+  template <class Reader>
+  static SampleStatus read(Reader& r, uint16_t, const GpioSnapshot&, float& value) {
+    return r.readAnalogPin(Pin, value);
+  }
+};
+
+// Sensor: which DS18B20 on the pin (0 = first found)
+template <int Channel, int Pin, uint8_t Sensor = 0>
+struct OneWirePin : ProfilePin<Channel, Pin, CH_ONEWIRE, Sensor> {
+  template <class Reader>
+  static SampleStatus read(Reader& r, uint16_t at, const GpioSnapshot&, float& value) {
+    return r.readOneWireAt(at, Sensor, value);
+  }
+};
+
+// FixedChannel's spi_* settings: 0 = SPI_DEFAULT_CLOCK, mode 0, no command, 1 byte
+template <int Channel, int CsPin, uint32_t ClockHz = 0, uint8_t Mode = 0, uint8_t Command = 0,
+          uint8_t Length = 0>
+struct SpiPin : ProfilePin<Channel, CsPin, CH_SPI, 0, ClockHz, Mode, Command, Length> {
+  template <class Reader>
+  static SampleStatus read(Reader& r, uint16_t, const GpioSnapshot&, float& value) {
+    return r.readSpiPin(CsPin, ClockHz, Mode, Command, Length, value);
+  }
+};
+
+// CH_COUNTER, CH_FREQUENCY or CH_DUTY
+template <int Channel, int Pin, ChannelType Type = CH_COUNTER>
+struct EdgePin : ProfilePin<Channel, Pin, Type> {
+  static_assert(Type == CH_COUNTER || Type == CH_FREQUENCY || Type == CH_DUTY,
+                "EdgePin takes CH_COUNTER, CH_FREQUENCY or CH_DUTY");
+
+  template <class Reader>
+  static SampleStatus read(Reader& r, uint16_t at, const GpioSnapshot&, float& value) {
+    return r.readEdgeAt(at, Type, value);
+  }
+};
+
+// ========== PROFILE ==========
+
+template <class... Pins>
+class BoardProfile {
+private:
+  static_assert(sizeof...(Pins) > 0, "a board profile needs at least one channel");
+
+  template <class... Rest>
+  struct List {
+    static constexpr bool ascending(int) { return true; }
+    static constexpr int maxChannel() { return -1; }
+    static constexpr bool uses(ScanBus) { return false; }
+  };
+
+  template <class First, class... Rest>
+  struct List<First, Rest...> {
+    static constexpr bool ascending(int previous) {
+      return First::channel > previous && List<Rest...>::ascending(First::channel);
+    }
+    static constexpr int maxChannel() {
+      return First::channel > List<Rest...>::maxChannel() ? First::channel
+                                                          : List<Rest...>::maxChannel();
+    }
+    static constexpr bool uses(ScanBus bus) {
+      return First::bus == bus || List<Rest...>::uses(bus);
+    }
+  };
+
+  static_assert(List<Pins...>::ascending(-1), "list profile channels in ascending order");
+
+  // Call v.entry<Pin>() for each channel on one bus, in listed order.
+  // The bus test is a constant, so only that bus's entries are emitted.
+  template <ScanBus Bus, class Visitor>
+  static void visitBus(Visitor& v) {
+    int expand[] = {0, (Pins::bus == Bus ? (v.template entry<Pins>(), 0) : 0)...};
+    (void)expand;
+  }
+
+  // Fixed buses in scan plan order; BUS_I2C is left to the runtime plan
+  template <class Visitor>
+  static void visit(Visitor& v) {
+    visitBus<BUS_GPIO>(v);
+    visitBus<BUS_ADC>(v);
+    v.adcDone();
+    visitBus<BUS_ONEWIRE>(v);
+    if (uses(BUS_SPI)) v.spiBegin();
+    visitBus<BUS_SPI>(v);
+    if (uses(BUS_SPI)) v.spiEnd();
+  }
+
+  template <class Reader>
+  struct Scan {
+    Reader& r;
+    const GpioSnapshot& gpio;
+    ScanFrame& frame;
+    size_t n;
+    size_t limit;
+    uint32_t lastUs;
+    uint16_t at;
+    bool timed;
+
+    template <class Pin>
+    void entry() {
+      uint16_t i = at++;
+      if (n >= limit) return;
+      if (Pin::bus != BUS_GPIO) lastUs = micros();
+      uint32_t start = timed ? cycleCount() : 0;
+      float value = 0;
+      SampleStatus status = Pin::read(r, i, gpio, value);
+      if (timed) {
+        r.getReadStats().recordRead(Pin::channel, Pin::bus, status, cycleCount() - start,
+                                    false);
+      }
+      frame.status[n] = status;
+      frame.value[n] = value;
+      frame.timestampUs[n] = lastUs;
+      frame.channel[n] = Pin::channel;
+      frame.sub[n] = 0;
+      n++;
+    }
+
+    void adcDone() {
+      frame.alignedEndUs = lastUs;
+    }
+
+    // SPI reads share one hold of the bus, as in the plan's scan
+    void spiBegin() {
+      r.beginSpiBatch();
+    }
+
+    void spiEnd() {
+      r.endSpiBatch();
+    }
+  };
+
+  template <class Fixed>
+  struct Match {
+    const ScanPlan& plan;
+    const std::vector<Fixed>& fixed;
+    uint16_t at;
+    bool ok;
+
+    template <class Pin>
+    void entry() {
+      uint16_t i = at++;
+      if (!ok || i >= plan.size()) {
+        ok = false;
+        return;
+      }
+      const ChannelSlot& slot = plan.slotAt(i);
+      const ProfileChannel p = Pin::describe();
+      ok = plan.channelAt(i) == p.channel && slot.type == p.type && slot.pin == p.pin;
+      if (ok && p.type == CH_ONEWIRE) ok = slot.sub == p.sensor;
+      if (ok && p.type == CH_SPI) {
+        const Fixed& f = fixed[slot.index];
+        ok = f.spiClockHz == p.spiClockHz && f.spiMode == p.spiMode &&
+             f.spiCommand == p.spiCommand && f.spiLength == p.spiLength;
+      }
+    }
+
+    void adcDone() {}
+    void spiBegin() {}
+    void spiEnd() {}
+  };
+
+public:
+  static constexpr size_t count() {
+    return sizeof...(Pins);
+  }
+
+  // Highest channel number, for checking against MAX_FIXED_CHANNELS
+  static constexpr int maxChannel() {
+    return List<Pins...>::maxChannel();
+  }
+
+  static constexpr bool uses(ScanBus bus) {
+    return List<Pins...>::uses(bus);
+  }
+
+  // The channels as a table in flash, in listed order
+  static const ProfileChannel* channels() {
+    static const ProfileChannel table[] = {Pins::describe()...};
+    return table;
+  }
+
+  static void setupPins() {
+    int expand[] = {0, (Pins::setup(), 0)...};
+    (void)expand;
+  }
+
+  // True while the plan's fixed channels are exactly this profile (all
+  // active, nothing changed at runtime), so scan() can stand in for them
+  template <class Fixed>
+  static bool matches(const ScanPlan& plan, const std::vector<Fixed>& fixed) {
+    Match<Fixed> m = {plan, fixed, 0, true};
+    visit(m);
+    return m.ok && plan.begin(BUS_I2C) == count();
+  }
+
+  // Read every profile channel into frame from position 0, in scan plan
+  // order. lastUs: time of the scan start in, of the last read out.
+  // Returns the samples written (capped at limit).
+  template <class Reader>
+  static size_t scan(Reader& r, ScanFrame& frame, size_t limit, uint32_t& lastUs) {
+    GpioSnapshot gpio;
+    if (uses(BUS_GPIO)) gpio.capture();
+    Scan<Reader> s = {r, gpio, frame, 0, limit, lastUs, 0, r.getReadStats().isEnabled()};
+    visit(s);
+    lastUs = s.lastUs;
+    return s.n;
+  }
+};
+
+// ========== PROFILES ==========
+
+// The layout example_createDefaultFixedChannels() builds, minus the
+// disabled channel 7
+typedef BoardProfile<DigitalPin<1, 2>,
+                     AnalogPin<2, 4>,
+                     OneWirePin<3, 5>,
+                     DigitalPin<4, 15>,
+                     SpiPin<5, 14>,
+                     SpiPin<6, 27>,
+                     OneWirePin<8, 5, 1>> DevKitProfile;
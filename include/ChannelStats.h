@@ -0,0 +1,181 @@
+/*
+ * Streaming channel statistics and output filtering
+ * Runs after a scan, once per sample, in constant memory per channel:
+ * - Window statistics: min/max/mean/variance over tumbling windows of N
+ *   samples, Welford's update on values shifted by the window's first
+ *   sample so float accumulators stay accurate on large offsets.
+ * - Decimation: pass every Nth sample.
+ * - Deadband: pass a sample only when it moved at least the deadband from
+ *   the last one passed, or when the report interval ran out.
+ * Status changes (a sensor failing or coming back) always pass, and the
+ * statistics see every sample, so filtering only cuts output volume.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+#include "ScanPlan.h"
+
+// Longest report interval: intervals are timed on micros(), which wraps
+// every 71.6 minutes
+#define MAX_REPORT_INTERVAL_MS 3600000UL
+
+// Per-channel settings, all zero = pass everything, no statistics
+struct FilterSettings {
+  uint16_t decimate;          // Pass every Nth sample, 0 or 1 = all
+  uint16_t statsWindow;       // Samples per statistics window, 0 = off
+  float deadband;             // Report-on-change threshold, 0 = off
+  uint32_t reportIntervalMs;  // Pass at least this often despite the deadband, 0 = never,
+                              // at most MAX_REPORT_INTERVAL_MS
+
+  bool enabled() const {
+    return decimate > 1 || statsWindow > 0 || deadband > 0;
+  }
+};
+
+// Summary of a statistics window
+struct WindowSummary {
+  uint32_t count;
+  float mean;
+  float variance;  // Sample variance (n - 1), 0 below two samples
+  float min;
+  float max;
+  uint32_t startUs;
+  uint32_t endUs;
+};
+
+// Welford accumulator. Values are shifted by the first one, so the
+// running mean and M2 stay small and float keeps its precision; the mean
+// update is compensated (Kahan) so long windows don't drift.
+class RunningStats {
+private:
+  uint32_t n = 0;
+  float shift = 0;
+  float mean = 0;  // Of (x - shift)
+  float meanC = 0; // Kahan compensation for mean
+  float m2 = 0;
+  float lo = 0;
+  float hi = 0;
+  uint32_t startUs = 0;
+  uint32_t lastUs = 0;
+
+public:
+  void reset() {
+    n = 0;
+    mean = 0;
+    meanC = 0;
+    m2 = 0;
+  }
+
+  void add(float x, uint32_t nowUs) {
+    if (n == 0) {
+      shift = x;
+      lo = hi = x;
+      startUs = nowUs;
+    }
+    float d = x - shift;
+    n++;
+    float delta = d - mean;
+    float step = delta / n - meanC;
+    float next = mean + step;
+    meanC = (next - mean) - step;
+    mean = next;
+    m2 += delta * (d - mean);
+    if (x < lo) lo = x;
+    if (x > hi) hi = x;
+    lastUs = nowUs;
+  }
+
+  uint32_t count() const {
+    return n;
+  }
+
+  WindowSummary summary() const {
+    WindowSummary s = {n, shift + mean, n > 1 ? m2 / (n - 1) : 0.0f, lo, hi, startUs, lastUs};
+    return s;
+  }
+};
+
+// Output stage for one channel value (one per I2C driver sub-channel)
+class ChannelFilter {
+private:
+  FilterSettings settings = {0, 0, 0, 0};
+  RunningStats window;
+  WindowSummary last = {0, 0, 0, 0, 0, 0, 0};  // Last completed window
+  uint16_t skip = 0;          // Samples since the last decimation tick
+  bool primed = false;        // Something has been passed
+  float reported = 0;         // Last value passed
+  uint8_t reportedStatus = 0;
+  uint32_t reportedUs = 0;
+  uint32_t seen = 0;
+  uint32_t passed = 0;
+
+public:
+  void configure(const FilterSettings& s) {
+    settings = s;
+    if (settings.reportIntervalMs > MAX_REPORT_INTERVAL_MS) {
+      settings.reportIntervalMs = MAX_REPORT_INTERVAL_MS;
+    }
+    window.reset();
+    last.count = 0;
+    skip = 0;
+    primed = false;
+    seen = 0;
+    passed = 0;
+  }
+
+  // Feed one sample; true if it should go downstream
+  bool accept(float value, uint8_t status, uint32_t nowUs) {
+    seen++;
+    if (status == SAMPLE_OK && settings.statsWindow) {
+      window.add(value, nowUs);
+      if (window.count() >= settings.statsWindow) {
+        last = window.summary();
+        window.reset();
+      }
+    }
+
+    bool pass = !primed || status != reportedStatus;
+    if (!pass) {
+      bool tick = ++skip >= (settings.decimate > 1 ? settings.decimate : 1);
+      if (tick) skip = 0;
+      bool moved = settings.deadband <= 0 ||
+                   (status == SAMPLE_OK && fabsf(value - reported) >= settings.deadband);
+      bool stale = settings.reportIntervalMs &&
+                   nowUs - reportedUs >= (uint64_t)settings.reportIntervalMs * 1000;
+      pass = stale || (tick && moved);
+    }
+    if (!pass) return false;
+
+    primed = true;
+    reported = value;
+    reportedStatus = status;
+    reportedUs = nowUs;
+    skip = 0;
+    passed++;
+    return true;
+  }
+
+  const FilterSettings& getSettings() const {
+    return settings;
+  }
+
+  // Last completed window, count == 0 until one completes
+  const WindowSummary& lastWindow() const {
+    return last;
+  }
+
+  // The window still filling
+  WindowSummary currentWindow() const {
+    return window.summary();
+  }
+
+  uint32_t seenCount() const {
+    return seen;
+  }
+
+  uint32_t passedCount() const {
+    return passed;
+  }
+};
@@ -0,0 +1,96 @@
+/*
+ * Compiled channel dispatch table
+ * Built by ConfigManager whenever the config loads or changes, so reads
+ * resolve a channel number with one bounds check and no String handling.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+enum ChannelType : uint8_t {
+  CH_NONE = 0,
+  CH_DIGITAL,
+  CH_ANALOG,
+  CH_ONEWIRE,
+  CH_SPI,
+  CH_I2C,
+  CH_COUNTER,    // Rising edges, counted by interrupt
+  CH_FREQUENCY,  // Hz from edge timestamps
+  CH_DUTY        // High time in percent
+};
+
+// Map a config mode string ("DIGITAL", "ANALOG", ...) to its type
+inline ChannelType channelTypeFromMode(const char* mode) {
+  if (strcmp(mode, "DIGITAL") == 0) return CH_DIGITAL;
+  if (strcmp(mode, "ANALOG") == 0) return CH_ANALOG;
+  if (strcmp(mode, "ONEWIRE") == 0) return CH_ONEWIRE;
+  if (strcmp(mode, "SPI") == 0) return CH_SPI;
+  if (strcmp(mode, "I2C") == 0) return CH_I2C;
+  if (strcmp(mode, "COUNTER") == 0) return CH_COUNTER;
+  if (strcmp(mode, "FREQUENCY") == 0) return CH_FREQUENCY;
+  if (strcmp(mode, "DUTY") == 0) return CH_DUTY;
+  return CH_NONE;
+}
+
+inline const char* channelTypeName(ChannelType type) {
+  switch (type) {
+    case CH_DIGITAL: return "DIGITAL";
+    case CH_ANALOG:  return "ANALOG";
+    case CH_ONEWIRE: return "ONEWIRE";
+    case CH_SPI:     return "SPI";
+    case CH_I2C:     return "I2C";
+    case CH_COUNTER: return "COUNTER";
+    case CH_FREQUENCY: return "FREQUENCY";
+    case CH_DUTY:    return "DUTY";
+    default:         return "NONE";
+  }
+}
+
+// One resolved channel, 8 bytes
+struct ChannelSlot {
+  ChannelType type;   // CH_NONE = unused or inactive
+  uint8_t address;    // I2C address (I2C only)
+  int16_t pin;        // GPIO / CS pin (fixed channels only)
+  uint16_t index;     // Position in fixedChannels or i2cChannels
+  uint8_t unit;       // Bus instance (ONEWIRE: DS18B20Bus index, edge modes: EdgeCounter
+                      // index, DIGITAL: GPIO register bank)
+  uint8_t sub;        // Device on that bus (ONEWIRE: sensor index, DIGITAL: register bit)
+};
+
+class ChannelTable {
+private:
+  std::vector<ChannelSlot> slots;  // Indexed directly by channel number
+
+public:
+  void clear() {
+    slots.clear();
+  }
+
+  // Size the table for channel numbers 0..maxChannel, all empty
+  void reset(int maxChannel) {
+    slots.assign(maxChannel < 0 ? 0 : maxChannel + 1, ChannelSlot{CH_NONE, 0, -1, 0, 0, 0});
+  }
+
+  // First writer wins, matching the old fixed-then-I2C lookup order
+  bool assign(int channel, const ChannelSlot& slot) {
+    if ((unsigned)channel >= slots.size() || slots[channel].type != CH_NONE) {
+      return false;
+    }
+    slots[channel] = slot;
+    return true;
+  }
+
+  // O(1) lookup, nullptr if the channel is not active or doesn't exist
+  const ChannelSlot* find(int channel) const {
+    if ((unsigned)channel >= slots.size()) return nullptr;
+    const ChannelSlot& slot = slots[channel];
+    return slot.type == CH_NONE ? nullptr : &slot;
+  }
+
+  size_t size() const {
+    return slots.size();
+  }
+};
@@ -0,0 +1,77 @@
+/*
+ * Binary config snapshot format
+ * saveConfig() writes the channel tables as fixed-size records next to
+ * config.json, tagged with a CRC32 of the JSON bytes they came from. At boot
+ * the snapshot is used directly when that tag matches the JSON on the card,
+ * skipping the JSON parse; any mismatch or corruption falls back to JSON.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "SampleLogFormat.h"
+#include "ChannelStats.h"
+
+#define SNAPSHOT_MAGIC 0x534E4353UL  // "SCNS" little-endian
+#define SNAPSHOT_VERSION 7
+
+#define SNAPSHOT_I2C_MISSING 0x01  // SnapshotI2C::flags, I2CChannel::missing
+
+struct SnapshotHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t fixedCount;
+  uint16_t i2cCount;
+  uint8_t oneWireResolution;
+  uint8_t reserved;
+  uint32_t i2cClockHz;
+  uint32_t adcStreamHz;     // Continuous ADC rate per pin, 0 = off
+  uint16_t adcOversample;
+  uint8_t adcSmoothing;
+  uint8_t reserved2;
+  uint32_t sourceHash;  // logCrc32 of the config.json bytes
+  uint32_t crc;         // logCrc32 of the header before this field and all records
+};
+
+struct SnapshotFixed {
+  int16_t channel;
+  int16_t pin;
+  uint8_t type;      // ChannelType
+  uint8_t active;
+  uint8_t sensor;
+  uint8_t reserved;
+  uint32_t periodUs;
+  uint32_t spiClockHz;
+  uint8_t spiMode;
+  uint8_t spiCommand;
+  uint8_t spiLength;
+  uint8_t reserved2;
+  FilterSettings filter;
+};
+
+struct SnapshotI2C {
+  int16_t channel;
+  int16_t id;
+  int16_t reg;
+  uint8_t address;
+  uint8_t active;
+  uint8_t length;
+  uint8_t flags;     // SNAPSHOT_I2C_*
+  uint8_t driver;    // Built-in I2CDriver position + 1, 0 = none
+  uint8_t reserved;
+  uint32_t periodUs;
+  FilterSettings filter;
+};
+
+static_assert(sizeof(SnapshotHeader) == 32, "SnapshotHeader layout changed");
+static_assert(sizeof(SnapshotFixed) == 32, "SnapshotFixed layout changed");
+static_assert(sizeof(SnapshotI2C) == 28, "SnapshotI2C layout changed");
+
+// Boot timing, reported by ConfigManager::getBootStats()
+struct BootStats {
+  bool fromSnapshot;       // Last loadConfig() used the binary snapshot
+  uint32_t loadStartUs;    // micros() when loadConfig() started
+  uint32_t configLoadUs;   // Time spent in loadConfig()
+  uint32_t firstSampleUs;  // loadConfig() start to the first completed read, 0 = none yet
+};
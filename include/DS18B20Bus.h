@@ -0,0 +1,184 @@
+/*
+ * Non-blocking DS18B20 bus driver
+ * One instance per OneWire pin. ROM codes are discovered once and cached,
+ * conversions are started for the whole bus with Skip ROM, and results are
+ * collected on a later service() call once the conversion time has passed.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <OneWire.h>
+#include "ScanPlan.h"
+
+#define MAX_ONEWIRE_BUSES 4     // Pins carrying DS18B20s
+#define MAX_ONEWIRE_DEVICES 8   // Sensors per pin
+#define ONEWIRE_REDISCOVER_MS 5000  // Retry interval when a bus is empty
+
+// ROM and function commands
+#define DS18B20_CONVERT_T 0x44
+#define DS18B20_READ_SCRATCHPAD 0xBE
+#define DS18B20_WRITE_SCRATCHPAD 0x4E
+
+class DS18B20Bus {
+private:
+  OneWire ow;
+  int pin = -1;
+  uint8_t resolution = 12;
+  uint8_t roms[MAX_ONEWIRE_DEVICES][8];
+  uint8_t deviceCount = 0;
+  float temps[MAX_ONEWIRE_DEVICES];
+  uint8_t status[MAX_ONEWIRE_DEVICES];  // SampleStatus per device
+  bool searched = false;    // At least one search attempted
+  bool discovered = false;  // Search found at least one sensor
+  bool converting = false;
+  bool resolutionPending = false;
+  uint32_t convertStartMs = 0;
+  uint32_t lastDiscoveryMs = 0;
+
+  static bool isTemperatureFamily(uint8_t family) {
+    return family == 0x28 || family == 0x22 || family == 0x10;  // DS18B20, DS1822, DS18S20
+  }
+
+  // 9 bits: 93.75 ms, each extra bit doubles it, 12 bits: 750 ms
+  uint32_t conversionTimeMs() const {
+    return 750 >> (12 - resolution);
+  }
+
+  // Search the bus and cache every temperature sensor's ROM
+  void discover(uint32_t nowMs) {
+    searched = true;
+    lastDiscoveryMs = nowMs;
+    deviceCount = 0;
+    uint8_t rom[8];
+    ow.reset_search();
+    while (deviceCount < MAX_ONEWIRE_DEVICES && ow.search(rom)) {
+      if (OneWire::crc8(rom, 7) != rom[7] || !isTemperatureFamily(rom[0])) continue;
+      memcpy(roms[deviceCount], rom, 8);
+      status[deviceCount] = SAMPLE_NOT_READY;
+      deviceCount++;
+    }
+    discovered = deviceCount > 0;
+    if (discovered) applyResolution();
+  }
+
+  // Write TH, TL and config to every device at once (DS18S20 ignores config)
+  void applyResolution() {
+    if (!ow.reset()) return;
+    ow.skip();
+    ow.write(DS18B20_WRITE_SCRATCHPAD);
+    ow.write(0x4B);  // TH (unused)
+    ow.write(0x46);  // TL (unused)
+    ow.write(((resolution - 9) << 5) | 0x1F);
+  }
+
+  void startConversion(uint32_t nowMs) {
+    if (!ow.reset()) {
+      for (uint8_t i = 0; i < deviceCount; i++) status[i] = SAMPLE_NO_DEVICE;
+      return;
+    }
+    ow.skip();
+    ow.write(DS18B20_CONVERT_T, 1);  // Keep the line powered for parasite devices
+    converting = true;
+    convertStartMs = nowMs;
+  }
+
+  void collect() {
+    for (uint8_t i = 0; i < deviceCount; i++) {
+      uint8_t data[9];
+      if (!ow.reset()) {
+        status[i] = SAMPLE_NO_DEVICE;
+        continue;
+      }
+      ow.select(roms[i]);
+      ow.write(DS18B20_READ_SCRATCHPAD);
+      ow.read_bytes(data, 9);
+      if (OneWire::crc8(data, 8) != data[8]) {
+        status[i] = SAMPLE_ERROR;
+        continue;
+      }
+      temps[i] = decode(roms[i][0], data);
+      status[i] = SAMPLE_OK;
+    }
+    converting = false;
+  }
+
+  float decode(uint8_t family, const uint8_t* data) const {
+    int16_t raw = (data[1] << 8) | data[0];
+    if (family == 0x10) {
+      // DS18S20: 9-bit base plus COUNT_REMAIN for extra precision
+      raw = raw << 3;
+      if (data[7] == 0x10) raw = (raw & 0xFFF0) + 12 - data[6];
+    } else {
+      // Undefined low bits at lower resolutions
+      raw &= ~((1 << (12 - resolution)) - 1);
+    }
+    return raw / 16.0f;
+  }
+
+public:
+  void begin(int busPin, uint8_t bits) {
+    pin = busPin;
+    resolution = constrain(bits, 9, 12);
+    ow.begin(pin);
+    deviceCount = 0;
+    searched = false;
+    discovered = false;
+    converting = false;
+  }
+
+  void end() {
+    pin = -1;
+    deviceCount = 0;
+    discovered = false;
+    converting = false;
+  }
+
+  int getPin() const {
+    return pin;
+  }
+
+  uint8_t getDeviceCount() const {
+    return deviceCount;
+  }
+
+  const uint8_t* getRom(uint8_t index) const {
+    return index < deviceCount ? roms[index] : nullptr;
+  }
+
+  void setResolution(uint8_t bits) {
+    resolution = constrain(bits, 9, 12);
+    resolutionPending = discovered;  // Applied before the next conversion
+  }
+
+  // Advance the bus state machine. Never waits for a conversion: either
+  // starts one, does nothing, or reads back results and starts the next.
+  void service(uint32_t nowMs) {
+    if (pin < 0) return;
+
+    if (!discovered) {
+      if (searched && nowMs - lastDiscoveryMs < ONEWIRE_REDISCOVER_MS) return;
+      discover(nowMs);
+      if (!discovered) return;
+    }
+
+    if (converting) {
+      if (nowMs - convertStartMs < conversionTimeMs()) return;
+      collect();
+    }
+
+    if (resolutionPending) {
+      applyResolution();
+      resolutionPending = false;
+    }
+    startConversion(nowMs);
+  }
+
+  // Latest temperature in degrees C for the index-th sensor on this pin
+  SampleStatus read(uint8_t index, float& value) const {
+    if (index >= deviceCount) return searched ? SAMPLE_NO_DEVICE : SAMPLE_NOT_READY;
+    if (status[index] != SAMPLE_OK) return (SampleStatus)status[index];
+    value = temps[index];
+    return SAMPLE_OK;
+  }
+};
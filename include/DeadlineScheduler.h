@@ -0,0 +1,130 @@
+/*
+ * Per-channel deadline scheduler
+ * Each scan plan entry has its own sampling period. Deadlines live in a
+ * min-heap, so finding what is due costs O(log n) per due channel and the
+ * caller can sleep until the earliest deadline instead of polling. Next
+ * deadlines advance from the previous deadline (not the read time), so
+ * periods don't drift; a channel late by whole periods skips them and
+ * counts each one as missed.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+
+// Timing statistics for one channel
+struct ChannelTiming {
+  uint32_t periodUs;
+  uint32_t samples;        // Reads done on schedule
+  uint32_t missed;         // Deadlines skipped: reader late, or too big for the frame
+  uint32_t lastJitterUs;   // Read time minus deadline, last read
+  uint32_t maxJitterUs;
+  uint64_t jitterSumUs;    // For the mean: jitterSumUs / samples
+};
+
+class DeadlineScheduler {
+private:
+  struct Deadline {
+    uint32_t dueUs;
+    uint16_t index;        // Scan plan index
+  };
+
+  std::vector<Deadline> heap;
+  std::vector<ChannelTiming> timing;  // By scan plan index
+  std::vector<uint32_t> dueAt;        // Deadline being served, by plan index
+  std::vector<uint8_t> values;        // Frame entries one read writes, by plan index
+
+  // Min-heap order on wrapping microsecond timestamps
+  static bool later(const Deadline& a, const Deadline& b) {
+    return (int32_t)(a.dueUs - b.dueUs) > 0;
+  }
+
+public:
+  // One entry per plan index; all channels are due at startUs.
+  // valueCounts: frame entries each channel's read writes.
+  void build(const std::vector<uint32_t>& periodsUs, const std::vector<uint8_t>& valueCounts,
+             uint32_t startUs) {
+    size_t n = periodsUs.size();
+    heap.clear();
+    heap.reserve(n);
+    timing.assign(n, ChannelTiming());
+    dueAt.assign(n, startUs);
+    values.assign(n, 1);
+    for (size_t i = 0; i < n; i++) {
+      timing[i].periodUs = std::max<uint32_t>(periodsUs[i], 1);
+      if (i < valueCounts.size()) values[i] = std::max<uint8_t>(valueCounts[i], 1);
+      heap.push_back({startUs, (uint16_t)i});
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
+  }
+
+  size_t size() const {
+    return timing.size();
+  }
+
+  // Move channels due at nowUs into out (unsorted), earliest first, while
+  // their values fit in maxValues, and schedule each one's next deadline.
+  // A channel that doesn't fit stays due for the next call, unless out is
+  // still empty (it could never fit). out needs size() entries.
+  size_t collectDue(uint32_t nowUs, uint16_t* out, size_t maxValues) {
+    size_t n = 0;
+    size_t left = maxValues;
+    while (!heap.empty() && (int32_t)(nowUs - heap.front().dueUs) >= 0) {
+      uint8_t need = values[heap.front().index];
+      if (need > left && n > 0) break;
+      left -= std::min<size_t>(need, left);
+      std::pop_heap(heap.begin(), heap.end(), later);
+      Deadline& d = heap.back();
+      ChannelTiming& t = timing[d.index];
+
+      uint32_t late = nowUs - d.dueUs;
+      if (late >= t.periodUs) {
+        uint32_t skipped = late / t.periodUs;
+        t.missed += skipped;
+        d.dueUs += skipped * t.periodUs;
+      }
+      dueAt[d.index] = d.dueUs;
+      out[n++] = d.index;
+
+      d.dueUs += t.periodUs;
+      std::push_heap(heap.begin(), heap.end(), later);
+    }
+    return n;
+  }
+
+  // Record the read of a channel returned by collectDue()
+  void markRead(uint16_t index, uint32_t readUs) {
+    ChannelTiming& t = timing[index];
+    uint32_t jitter = readUs - dueAt[index];
+    t.samples++;
+    t.lastJitterUs = jitter;
+    t.maxJitterUs = std::max(t.maxJitterUs, jitter);
+    t.jitterSumUs += jitter;
+  }
+
+  // A channel returned by collectDue() that was not read
+  void markMissed(uint16_t index) {
+    timing[index].missed++;
+  }
+
+  // Microseconds until the earliest deadline, 0 if one is already due
+  uint32_t timeToNextUs(uint32_t nowUs) const {
+    if (heap.empty()) return UINT32_MAX;
+    int32_t wait = (int32_t)(heap.front().dueUs - nowUs);
+    return wait > 0 ? (uint32_t)wait : 0;
+  }
+
+  const ChannelTiming* getTiming(size_t index) const {
+    return index < timing.size() ? &timing[index] : nullptr;
+  }
+
+  void resetStats() {
+    for (auto& t : timing) {
+      uint32_t period = t.periodUs;
+      t = ChannelTiming();
+      t.periodUs = period;
+    }
+  }
+};
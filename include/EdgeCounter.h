@@ -0,0 +1,163 @@
+/*
+ * Interrupt-driven edge counter
+ * One instance per COUNTER / FREQUENCY / DUTY pin. A CHANGE interrupt
+ * counts rising edges and timestamps both edges, so pulses between scans
+ * are never missed and a read only copies a few words. Frequency uses
+ * reciprocal counting (edges since the last read over the time between
+ * their first and last rise), which stays precise at low rates; duty
+ * cycle comes from the last high time and period. The ISR publishes
+ * through a sequence counter, so it never waits on a reader.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include "ChannelTable.h"
+#include "ScanPlan.h"
+
+#define MAX_EDGE_COUNTERS 8  // COUNTER / FREQUENCY / DUTY pins
+
+class EdgeCounter {
+private:
+  // Written only by the ISR, copied out with snapshot()
+  struct EdgeState {
+    uint32_t rises;        // Rising edges since begin()
+    uint32_t lastRiseUs;
+    uint32_t periodUs;     // Last rise to rise, 0 = fewer than two rises
+    uint32_t highUs;       // Last rise to fall
+    uint8_t level;
+  };
+
+  int pin = -1;
+  std::atomic<uint32_t> seq{0};  // Odd while the ISR is writing
+  volatile EdgeState isrState = {0, 0, 0, 0, 0};
+
+  // Reader side (one reader at a time, e.g. the acquisition task)
+  uint32_t countBase = 0;   // rises at the last resetCount()
+  uint32_t freqRises = 0;   // rises at the last frequency read
+  uint32_t freqRiseUs = 0;
+  bool freqPrimed = false;
+  float lastHz = 0;
+
+  static void IRAM_ATTR onChange(void* arg) {
+    EdgeCounter* self = (EdgeCounter*)arg;
+    uint32_t now = micros();
+    uint8_t level = digitalRead(self->pin) ? 1 : 0;
+    volatile EdgeState& s = self->isrState;
+    if (level == s.level) return;  // Glitch shorter than the ISR latency
+
+    uint32_t seq = self->seq.load(std::memory_order_relaxed);
+    self->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (level) {
+      if (s.rises > 0) s.periodUs = now - s.lastRiseUs;
+      s.lastRiseUs = now;
+      s.rises = s.rises + 1;
+    } else if (s.rises > 0) {
+      s.highUs = now - s.lastRiseUs;
+    }
+    s.level = level;
+    std::atomic_thread_fence(std::memory_order_release);
+    self->seq.store(seq + 2, std::memory_order_relaxed);
+  }
+
+  // Consistent copy of the ISR state; retries while an edge is being recorded
+  EdgeState snapshot() const {
+    EdgeState copy;
+    uint32_t before, after;
+    do {
+      before = seq.load(std::memory_order_acquire);
+      copy.rises = isrState.rises;
+      copy.lastRiseUs = isrState.lastRiseUs;
+      copy.periodUs = isrState.periodUs;
+      copy.highUs = isrState.highUs;
+      copy.level = isrState.level;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = seq.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return copy;
+  }
+
+public:
+  ~EdgeCounter() {
+    end();
+  }
+
+  void begin(int gpio) {
+    end();
+    pin = gpio;
+    pinMode(pin, INPUT);
+    isrState.rises = 0;
+    isrState.lastRiseUs = 0;
+    isrState.periodUs = 0;
+    isrState.highUs = 0;
+    isrState.level = digitalRead(pin) ? 1 : 0;
+    countBase = 0;
+    freqPrimed = false;
+    lastHz = 0;
+    attachInterruptArg(pin, onChange, this, CHANGE);
+  }
+
+  void end() {
+    if (pin < 0) return;
+    detachInterrupt(pin);
+    pin = -1;
+  }
+
+  int getPin() const {
+    return pin;
+  }
+
+  // Rising edges since begin() or the last resetCount()
+  uint32_t count() const {
+    return snapshot().rises - countBase;
+  }
+
+  void resetCount() {
+    countBase = snapshot().rises;
+  }
+
+  // Hz from the edges since the last call. With no new edge the estimate
+  // can only fall: it is capped by one period ending now, decaying to 0.
+  float frequency(uint32_t nowUs) {
+    EdgeState s = snapshot();
+    if (s.rises == 0) return lastHz = 0;
+
+    if (s.rises != freqRises) {
+      if (freqPrimed && s.lastRiseUs != freqRiseUs) {
+        lastHz = (s.rises - freqRises) * 1000000.0f / (uint32_t)(s.lastRiseUs - freqRiseUs);
+      } else if (s.periodUs > 0) {
+        lastHz = 1000000.0f / s.periodUs;
+      }
+      freqRises = s.rises;
+      freqRiseUs = s.lastRiseUs;
+      freqPrimed = true;
+    } else {
+      uint32_t since = nowUs - s.lastRiseUs;
+      if (since > 0) lastHz = std::min(lastHz, 1000000.0f / since);
+    }
+    return lastHz;
+  }
+
+  // High time over period in percent; a stalled line reads 0 or 100
+  float dutyPercent(uint32_t nowUs) const {
+    EdgeState s = snapshot();
+    if (s.periodUs == 0 || nowUs - s.lastRiseUs > 2 * s.periodUs) {
+      return s.level ? 100.0f : 0.0f;
+    }
+    float duty = 100.0f * s.highUs / s.periodUs;
+    return duty > 100.0f ? 100.0f : duty;
+  }
+
+  // Value for an edge channel type
+  SampleStatus read(ChannelType type, uint32_t nowUs, float& value) {
+    switch (type) {
+      case CH_COUNTER:   value = count(); return SAMPLE_OK;
+      case CH_FREQUENCY: value = frequency(nowUs); return SAMPLE_OK;
+      case CH_DUTY:      value = dutyPercent(nowUs); return SAMPLE_OK;
+      default:           return SAMPLE_ERROR;
+    }
+  }
+};
@@ -0,0 +1,43 @@
+/*
+ * Port-wide GPIO input snapshot
+ * Reads the GPIO input registers once (pins 0-31 and 32-63), so a scan
+ * decodes every DIGITAL channel from the same instant with a shift and
+ * mask instead of one digitalRead() per pin.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#if defined(ESP32)
+#include <soc/gpio_reg.h>
+#endif
+
+#define GPIO_BANKS 2
+
+struct GpioSnapshot {
+  uint32_t in[GPIO_BANKS];
+
+  void capture() {
+#if defined(ESP32)
+    in[0] = REG_READ(GPIO_IN_REG);
+    in[1] = REG_READ(GPIO_IN1_REG);
+#else
+    in[0] = Sim.readGpioBank(0);
+    in[1] = Sim.readGpioBank(1);
+#endif
+  }
+
+  // Where a pin's level sits in the snapshot, computed once per channel
+  static uint8_t bankOf(int pin) {
+    return (pin >> 5) & (GPIO_BANKS - 1);
+  }
+
+  static uint8_t bitOf(int pin) {
+    return pin & 31;
+  }
+
+  uint8_t level(uint8_t bank, uint8_t bit) const {
+    return (in[bank] >> bit) & 1;
+  }
+};
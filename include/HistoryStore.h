@@ -0,0 +1,532 @@
+/*
+ * Per-channel sample history, kept in PSRAM when the board has it
+ * begin() allocates a fixed pool of points once and splits it evenly
+ * between up to maxSeries (channel, sub) series. Each series is a ring of
+ * segments; when the ring is full the oldest segment is reused, so
+ * recording never allocates. Segments keep count/min/max/sum, so a
+ * window aggregate only walks points in the two partly covered segments
+ * at its ends.
+ * Times are 64-bit microseconds: the 32-bit sample timestamps unwrapped
+ * across micros() rollover (timeOf()). Only SAMPLE_OK values are stored.
+ * Not thread-safe: record and query from the same task, e.g. the one
+ * draining the acquisition ring.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "SampleRing.h"
+#include "ScanPlan.h"
+
+#define HISTORY_SEGMENT_POINTS 128
+
+// One point as returned by queries
+struct HistoryPoint {
+  uint64_t timeUs;
+  float value;
+};
+
+// Min/max/mean over a time window
+struct HistoryAggregate {
+  uint32_t count;  // 0 = no points in the window
+  float min;
+  float max;
+  float mean;
+  uint64_t firstUs;
+  uint64_t lastUs;
+};
+
+struct HistoryInfo {
+  uint32_t count;     // Points held
+  uint32_t capacity;  // Points the series can hold
+  uint64_t oldestUs;
+  uint64_t newestUs;
+  uint32_t missed;    // Samples not stored because the read failed
+};
+
+class HistoryStore {
+private:
+  // 8 bytes per point in the pool, time relative to its segment
+  struct Entry {
+    uint32_t offsetUs;
+    float value;
+  };
+
+  struct Segment {
+    uint64_t baseUs;
+    uint32_t count;
+    float first;  // Sum is of (value - first), like RunningStats' shift
+    float sum;
+    float min;
+    float max;
+  };
+
+  struct Series {
+    int32_t key;      // channel << 8 | sub
+    uint16_t head;    // Oldest segment in the ring
+    uint16_t used;    // Segments holding points
+    uint32_t missed;
+    uint64_t newestUs;
+  };
+
+  // Position of a point: segment j (0 = oldest) of a series, point k
+  struct Cursor {
+    uint16_t j;
+    uint32_t k;
+  };
+
+  Entry* points = nullptr;
+  Segment* segments = nullptr;
+  Series* series = nullptr;
+  int16_t* table = nullptr;  // Open-addressed key -> series index, -1 = empty
+  uint32_t tableMask = 0;
+  uint16_t maxSeries = 0;
+  uint16_t seriesUsed = 0;
+  uint16_t perSeries = 0;     // Segments per series
+  uint32_t segmentPoints = 0;
+  uint32_t unmapped = 0;      // Samples dropped because every series was taken
+  uint64_t clock = 0;         // Last unwrapped time
+  bool clockSet = false;
+
+  static int32_t keyOf(int16_t channel, uint8_t sub) {
+    return ((int32_t)channel << 8) | sub;
+  }
+
+  uint32_t hashOf(int32_t key) const {
+    return ((uint32_t)key * 2654435761u >> 16) & tableMask;
+  }
+
+  int findSeries(int16_t channel, uint8_t sub) const {
+    if (!table) return -1;
+    int32_t key = keyOf(channel, sub);
+    for (uint32_t h = hashOf(key);; h = (h + 1) & tableMask) {
+      if (table[h] < 0) return -1;
+      if (series[table[h]].key == key) return table[h];
+    }
+  }
+
+  int findOrAddSeries(int16_t channel, uint8_t sub) {
+    int32_t key = keyOf(channel, sub);
+    uint32_t h = hashOf(key);
+    for (; table[h] >= 0; h = (h + 1) & tableMask) {
+      if (series[table[h]].key == key) return table[h];
+    }
+    if (seriesUsed >= maxSeries) return -1;
+    Series& s = series[seriesUsed];
+    s.key = key;
+    s.head = 0;
+    s.used = 0;
+    s.missed = 0;
+    s.newestUs = 0;
+    table[h] = seriesUsed;
+    return seriesUsed++;
+  }
+
+  uint32_t segmentIndex(int s, uint16_t j) const {
+    return (uint32_t)s * perSeries + (series[s].head + j) % perSeries;
+  }
+
+  const Segment& segmentAt(int s, uint16_t j) const {
+    return segments[segmentIndex(s, j)];
+  }
+
+  const Entry* entriesAt(int s, uint16_t j) const {
+    return points + (size_t)segmentIndex(s, j) * segmentPoints;
+  }
+
+  uint64_t timeAt(int s, const Cursor& c) const {
+    return segmentAt(s, c.j).baseUs + entriesAt(s, c.j)[c.k].offsetUs;
+  }
+
+  float valueAt(int s, const Cursor& c) const {
+    return entriesAt(s, c.j)[c.k].value;
+  }
+
+  bool valid(int s, const Cursor& c) const {
+    return c.j < series[s].used;
+  }
+
+  void advance(int s, Cursor& c) const {
+    if (++c.k >= segmentAt(s, c.j).count) {
+      c.j++;
+      c.k = 0;
+    }
+  }
+
+  // First point at or after timeUs; past the end if there is none
+  Cursor locate(int s, uint64_t timeUs) const {
+    uint16_t lo = 0, hi = series[s].used;
+    while (lo < hi) {  // First segment whose last point is >= timeUs
+      uint16_t mid = (lo + hi) / 2;
+      const Segment& seg = segmentAt(s, mid);
+      if (seg.baseUs + entriesAt(s, mid)[seg.count - 1].offsetUs < timeUs) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    Cursor c = {lo, 0};
+    if (lo >= series[s].used) return c;
+    const Segment& seg = segmentAt(s, lo);
+    if (timeUs <= seg.baseUs) return c;
+    uint64_t offset = timeUs - seg.baseUs;
+    const Entry* e = entriesAt(s, lo);
+    uint32_t a = 0, b = seg.count;
+    while (a < b) {
+      uint32_t mid = (a + b) / 2;
+      if (e[mid].offsetUs < offset) {
+        a = mid + 1;
+      } else {
+        b = mid;
+      }
+    }
+    c.k = a;
+    return c;
+  }
+
+  // First point after timeUs
+  Cursor locateAfter(int s, uint64_t timeUs) const {
+    if (timeUs == UINT64_MAX) {
+      Cursor end = {series[s].used, 0};
+      return end;
+    }
+    return locate(s, timeUs + 1);
+  }
+
+  // Points before the cursor, counted from the oldest
+  uint32_t ordinal(int s, const Cursor& c) const {
+    uint32_t n = c.k;
+    for (uint16_t j = 0; j < c.j && j < series[s].used; j++) n += segmentAt(s, j).count;
+    return n;
+  }
+
+  // Start a new newest segment, reusing the oldest when the ring is full
+  Segment& openSegment(Series& ser, int s, uint64_t timeUs) {
+    if (ser.used < perSeries) {
+      ser.used++;
+    } else {
+      ser.head = (ser.head + 1) % perSeries;
+    }
+    Segment& seg = segments[segmentIndex(s, ser.used - 1)];
+    seg.baseUs = timeUs;
+    seg.count = 0;
+    return seg;
+  }
+
+  HistoryPoint pointAt(int s, const Cursor& c) const {
+    HistoryPoint p = {timeAt(s, c), valueAt(s, c)};
+    return p;
+  }
+
+public:
+  HistoryStore() {}
+  HistoryStore(const HistoryStore&) = delete;
+  HistoryStore& operator=(const HistoryStore&) = delete;
+
+  ~HistoryStore() {
+    end();
+  }
+
+  // Allocate room for maxPoints points shared by up to seriesCount series.
+  // Each series needs at least two segments.
+  bool begin(size_t maxPoints, uint16_t seriesCount,
+             uint32_t pointsPerSegment = HISTORY_SEGMENT_POINTS) {
+    end();
+    if (seriesCount == 0 || seriesCount > 0x7FFF || pointsPerSegment == 0) return false;
+    size_t per = maxPoints / pointsPerSegment / seriesCount;
+    if (per < 2) return false;
+    if (per > 0xFFFF) per = 0xFFFF;
+    uint32_t tableSize = 2;
+    while (tableSize < 2u * seriesCount) tableSize <<= 1;
+
+    size_t segmentCount = per * seriesCount;
+    points = (Entry*)ringAlloc(segmentCount * pointsPerSegment * sizeof(Entry));
+    segments = (Segment*)malloc(segmentCount * sizeof(Segment));
+    series = (Series*)malloc(seriesCount * sizeof(Series));
+    table = (int16_t*)malloc(tableSize * sizeof(int16_t));
+    if (!points || !segments || !series || !table) {
+      end();
+      return false;
+    }
+    perSeries = per;
+    segmentPoints = pointsPerSegment;
+    maxSeries = seriesCount;
+    tableMask = tableSize - 1;
+    clear();
+    return true;
+  }
+
+  void end() {
+    if (points) ringFree(points);
+    free(segments);
+    free(series);
+    free(table);
+    points = nullptr;
+    segments = nullptr;
+    series = nullptr;
+    table = nullptr;
+    maxSeries = 0;
+    seriesUsed = 0;
+  }
+
+  bool isStarted() const {
+    return points != nullptr;
+  }
+
+  // Forget every series; the memory stays allocated
+  void clear() {
+    if (table) memset(table, 0xFF, (tableMask + 1) * sizeof(int16_t));
+    seriesUsed = 0;
+    unmapped = 0;
+  }
+
+  // Unwrap a 32-bit microsecond timestamp into history time. Timestamps
+  // must arrive within ~35 minutes of each other.
+  uint64_t timeOf(uint32_t us) {
+    if (!clockSet) {
+      clock = us;
+      clockSet = true;
+      return clock;
+    }
+    uint64_t t = clock + (int64_t)(int32_t)(us - (uint32_t)clock);
+    if (t > clock) clock = t;
+    return t;
+  }
+
+  // Store one sample; false if it wasn't stored (failed read, no room
+  // for another series, or not started)
+  bool record(int16_t channel, uint8_t sub, uint8_t status, float value, uint32_t timestampUs) {
+    if (!points) return false;
+    uint64_t t = timeOf(timestampUs);
+    int s = findOrAddSeries(channel, sub);
+    if (s < 0) {
+      unmapped++;
+      return false;
+    }
+    Series& ser = series[s];
+    if (status != SAMPLE_OK) {
+      ser.missed++;
+      return false;
+    }
+    if (t < ser.newestUs) t = ser.newestUs;  // Keep each series in time order
+
+    Segment* seg = ser.used ? &segments[segmentIndex(s, ser.used - 1)] : nullptr;
+    if (!seg || seg->count >= segmentPoints || t - seg->baseUs > 0xFFFFFFFFull) {
+      seg = &openSegment(ser, s, t);
+    }
+    Entry& e = points[(size_t)(seg - segments) * segmentPoints + seg->count];
+    e.offsetUs = (uint32_t)(t - seg->baseUs);
+    e.value = value;
+    if (seg->count == 0) {
+      seg->first = seg->min = seg->max = value;
+      seg->sum = 0;
+    } else {
+      seg->sum += value - seg->first;
+      if (value < seg->min) seg->min = value;
+      if (value > seg->max) seg->max = value;
+    }
+    seg->count++;
+    ser.newestUs = t;
+    return true;
+  }
+
+  // Store every sample of a scan; returns how many were stored
+  size_t record(const ScanFrame& frame) {
+    size_t n = 0;
+    for (size_t i = 0; i < frame.count; i++) {
+      n += record(frame.channel[i], frame.sub[i], frame.status[i], frame.value[i],
+                  frame.timestampUs[i]);
+    }
+    return n;
+  }
+
+  // ========== QUERIES ==========
+
+  // The newest n points, oldest first; returns the number written
+  size_t latest(int16_t channel, uint8_t sub, HistoryPoint* out, size_t n) const {
+    int s = findSeries(channel, sub);
+    if (s < 0 || n == 0) return 0;
+    Cursor c = {series[s].used, 0};
+    size_t skip = n;
+    while (c.j > 0 && skip > 0) {  // Walk back whole segments
+      uint32_t count = segmentAt(s, c.j - 1).count;
+      c.j--;
+      if (count >= skip) {
+        c.k = count - skip;
+        skip = 0;
+      } else {
+        skip -= count;
+      }
+    }
+    size_t written = 0;
+    for (; valid(s, c) && written < n; advance(s, c)) out[written++] = pointAt(s, c);
+    return written;
+  }
+
+  // Points with fromUs <= time <= toUs, oldest first, at most max
+  size_t range(int16_t channel, uint8_t sub, uint64_t fromUs, uint64_t toUs, HistoryPoint* out,
+               size_t max) const {
+    int s = findSeries(channel, sub);
+    if (s < 0) return 0;
+    size_t n = 0;
+    for (Cursor c = locate(s, fromUs); valid(s, c) && n < max; advance(s, c)) {
+      uint64_t t = timeAt(s, c);
+      if (t > toUs) break;
+      HistoryPoint p = {t, valueAt(s, c)};
+      out[n++] = p;
+    }
+    return n;
+  }
+
+  // Min/max/mean of the points with fromUs <= time <= toUs
+  HistoryAggregate aggregate(int16_t channel, uint8_t sub, uint64_t fromUs, uint64_t toUs) const {
+    HistoryAggregate a = {0, 0, 0, 0, 0, 0};
+    int s = findSeries(channel, sub);
+    if (s < 0 || toUs < fromUs) return a;
+    Cursor c = locate(s, fromUs);
+    Cursor stop = locateAfter(s, toUs);
+    if (!valid(s, c) || (c.j == stop.j && c.k >= stop.k)) return a;
+
+    double sum = 0;
+    a.min = a.max = valueAt(s, c);
+    a.firstUs = timeAt(s, c);
+    while (valid(s, c) && (c.j < stop.j || c.k < stop.k)) {
+      const Segment& seg = segmentAt(s, c.j);
+      if (c.k == 0 && c.j < stop.j) {  // Whole segment from its summary
+        sum += (double)seg.first * seg.count + seg.sum;
+        a.count += seg.count;
+        if (seg.min < a.min) a.min = seg.min;
+        if (seg.max > a.max) a.max = seg.max;
+        c.j++;
+        continue;
+      }
+      float v = valueAt(s, c);
+      sum += v;
+      a.count++;
+      if (v < a.min) a.min = v;
+      if (v > a.max) a.max = v;
+      advance(s, c);
+    }
+    Cursor last = stop;
+    if (last.k > 0) {
+      last.k--;
+    } else {
+      last.j--;
+      last.k = segmentAt(s, last.j).count - 1;
+    }
+    a.lastUs = timeAt(s, last);
+    a.mean = sum / a.count;
+    return a;
+  }
+
+  // Reduce the points with fromUs <= time <= toUs to at most maxPoints
+  // with Largest-Triangle-Three-Buckets: keeps the first and last point and
+  // from each bucket the one that best preserves the curve's shape, so
+  // spikes survive where averaging or decimation would drop them.
+  size_t downsample(int16_t channel, uint8_t sub, uint64_t fromUs, uint64_t toUs,
+                    HistoryPoint* out, size_t maxPoints) const {
+    int s = findSeries(channel, sub);
+    if (s < 0 || maxPoints == 0 || toUs < fromUs) return 0;
+    Cursor start = locate(s, fromUs);
+    uint32_t first = ordinal(s, start);
+    uint32_t n = ordinal(s, locateAfter(s, toUs)) - first;
+    if (n <= maxPoints || maxPoints < 3) {
+      return range(channel, sub, fromUs, toUs, out, maxPoints);
+    }
+
+    double every = (double)(n - 2) / (maxPoints - 2);
+    Cursor cur = start;
+    HistoryPoint a = pointAt(s, cur);
+    out[0] = a;
+    advance(s, cur);           // Current bucket scan, from index 1
+    Cursor avgCursor = cur;    // Next bucket average, runs ahead
+    uint32_t avgIndex = 1;
+    uint32_t curIndex = 1;
+    size_t written = 1;
+
+    for (size_t b = 0; b < maxPoints - 2; b++) {
+      uint32_t avgStart = (uint32_t)((b + 1) * every) + 1;
+      uint32_t avgEnd = (uint32_t)((b + 2) * every) + 1;
+      if (avgStart > n - 1) avgStart = n - 1;  // Last bucket: the final point
+      if (avgEnd > n) avgEnd = n;
+      if (avgEnd <= avgStart) avgEnd = avgStart + 1;
+      while (avgIndex < avgStart) {
+        advance(s, avgCursor);
+        avgIndex++;
+      }
+      // Everything relative to a, so float only sees differences
+      uint64_t dtSum = 0;
+      float dvSum = 0;
+      Cursor scan = avgCursor;
+      for (uint32_t i = avgStart; i < avgEnd; i++) {
+        dtSum += timeAt(s, scan) - a.timeUs;
+        dvSum += valueAt(s, scan) - a.value;
+        advance(s, scan);
+      }
+      float avgDt = (float)dtSum / (avgEnd - avgStart);
+      float avgDv = dvSum / (avgEnd - avgStart);
+
+      uint32_t bucketEnd = (uint32_t)((b + 1) * every) + 1;
+      float bestArea = -1;
+      HistoryPoint best = a;
+      for (; curIndex < bucketEnd; curIndex++, advance(s, cur)) {
+        float dt = (float)(timeAt(s, cur) - a.timeUs);
+        float v = valueAt(s, cur);
+        float area = fabsf(dt * avgDv - avgDt * (v - a.value));  // Twice the triangle
+        if (area > bestArea) {
+          bestArea = area;
+          best.timeUs = timeAt(s, cur);
+          best.value = v;
+        }
+      }
+      out[written++] = best;
+      a = best;
+    }
+    while (curIndex < n - 1) {
+      advance(s, cur);
+      curIndex++;
+    }
+    out[written++] = pointAt(s, cur);
+    return written;
+  }
+
+  // Size and span of a series; count == 0 if it has nothing
+  HistoryInfo info(int16_t channel, uint8_t sub) const {
+    HistoryInfo i = {0, capacityPerSeries(), 0, 0, 0};
+    int s = findSeries(channel, sub);
+    if (s < 0) return i;
+    Cursor end = {series[s].used, 0};
+    i.count = ordinal(s, end);
+    if (i.count > 0) {
+      Cursor oldest = {0, 0};
+      i.oldestUs = timeAt(s, oldest);
+      i.newestUs = series[s].newestUs;
+    }
+    i.missed = series[s].missed;
+    return i;
+  }
+
+  uint32_t capacityPerSeries() const {
+    return (uint32_t)perSeries * segmentPoints;
+  }
+
+  uint16_t seriesCount() const {
+    return seriesUsed;
+  }
+
+  // Samples dropped because all series were taken
+  uint32_t unmappedCount() const {
+    return unmapped;
+  }
+
+  // Bytes allocated by begin()
+  size_t memoryBytes() const {
+    if (!points) return 0;
+    size_t segmentCount = (size_t)perSeries * maxSeries;
+    return segmentCount * (segmentPoints * sizeof(Entry) + sizeof(Segment)) +
+           maxSeries * sizeof(Series) + (tableMask + 1) * sizeof(int16_t);
+  }
+};
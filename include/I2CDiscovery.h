@@ -0,0 +1,124 @@
+/*
+ * Incremental I2C bus discovery
+ * Probes the 7-bit address range a few addresses at a time (or all at
+ * once) with address-only writes at a raised clock and a short timeout,
+ * and keeps a present/absent map. A device must miss several sweeps in a
+ * row before it counts as gone, so one glitched probe doesn't drop it.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "I2CEngine.h"
+
+#define I2C_FIRST_ADDRESS 0x08   // 0x00-0x07 and 0x78-0x7F are reserved
+#define I2C_LAST_ADDRESS 0x77
+#define I2C_MISSES_TO_REMOVE 2   // Consecutive missed sweeps before a device is gone
+
+class I2CDiscovery {
+private:
+  uint32_t present[4];          // Bit per address
+  uint8_t misses[128];          // Consecutive failed probes per address
+  uint8_t cursor = I2C_FIRST_ADDRESS;
+  uint32_t sweeps = 0;          // Completed passes over the address range
+  bool changed = false;         // Present/absent map changed since clearChanges()
+
+  void setPresent(uint8_t address, bool on) {
+    if (on) {
+      present[address >> 5] |= 1UL << (address & 31);
+    } else {
+      present[address >> 5] &= ~(1UL << (address & 31));
+    }
+  }
+
+  void markPresent(uint8_t address) {
+    misses[address] = 0;
+    if (!isPresent(address)) changed = true;
+    setPresent(address, true);
+  }
+
+  void markAbsent(uint8_t address) {
+    if (misses[address] >= I2C_MISSES_TO_REMOVE) return;
+    misses[address] = I2C_MISSES_TO_REMOVE;
+    setPresent(address, false);
+    changed = true;
+  }
+
+public:
+  I2CDiscovery() {
+    reset();
+  }
+
+  void reset() {
+    memset(present, 0, sizeof(present));
+    memset(misses, 0, sizeof(misses));
+    cursor = I2C_FIRST_ADDRESS;
+    sweeps = 0;
+    changed = false;
+  }
+
+  // Probe up to count addresses from where the last step stopped.
+  // Returns true when this step completed a sweep.
+  bool step(I2CEngine& engine, uint8_t count) {
+    bool wrapped = false;
+    engine.beginProbes();
+    for (uint8_t i = 0; i < count; i++) {
+      if (engine.probe(cursor)) {
+        markPresent(cursor);
+      } else if (misses[cursor] + 1 >= I2C_MISSES_TO_REMOVE) {
+        markAbsent(cursor);
+      } else {
+        misses[cursor]++;
+      }
+      if (++cursor > I2C_LAST_ADDRESS) {
+        cursor = I2C_FIRST_ADDRESS;
+        sweeps++;
+        wrapped = true;
+      }
+    }
+    engine.endProbes();
+    return wrapped;
+  }
+
+  // Probe the whole range now; a single miss counts as absent
+  void fullScan(I2CEngine& engine) {
+    engine.beginProbes();
+    for (uint8_t address = I2C_FIRST_ADDRESS; address <= I2C_LAST_ADDRESS; address++) {
+      if (engine.probe(address)) {
+        markPresent(address);
+      } else {
+        markAbsent(address);
+      }
+    }
+    engine.endProbes();
+    cursor = I2C_FIRST_ADDRESS;
+    sweeps++;
+  }
+
+  bool isPresent(uint8_t address) const {
+    return present[(address & 0x7F) >> 5] & (1UL << (address & 31));
+  }
+
+  // Probed and confirmed missing (never seen, or gone for enough sweeps)
+  bool isAbsent(uint8_t address) const {
+    return !isPresent(address) && misses[address & 0x7F] >= I2C_MISSES_TO_REMOVE;
+  }
+
+  int presentCount() const {
+    int n = 0;
+    for (uint8_t a = I2C_FIRST_ADDRESS; a <= I2C_LAST_ADDRESS; a++) n += isPresent(a);
+    return n;
+  }
+
+  bool hasChanges() const {
+    return changed;
+  }
+
+  void clearChanges() {
+    changed = false;
+  }
+
+  uint32_t sweepCount() const {
+    return sweeps;
+  }
+};
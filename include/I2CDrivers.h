@@ -0,0 +1,262 @@
+/*
+ * I2C sensor drivers
+ * A driver is a constant description of a device: register writes that
+ * configure it, optional calibration bytes read once, and one burst read
+ * of contiguous registers decoded into up to I2C_MAX_VALUES values
+ * (sub-channels). Channels name their driver in the config; the name is
+ * resolved to a driver when the channel table is built, so a scan does
+ * one combined I2C transaction per device and a decode call.
+ *
+ * Add a driver: define an I2CDriver and call registerI2CDriver() before
+ * the config is loaded.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "I2CEngine.h"
+
+#define I2C_MAX_VALUES 8       // Sub-channels per device
+#define I2C_MAX_BURST 16       // Bytes per burst read
+#define I2C_MAX_CALIBRATION 24 // Calibration bytes kept per device
+#define I2C_MAX_DRIVERS 16     // Built-in plus registered
+#define I2C_BUILTIN_DRIVERS 4  // Fixed registry positions, safe to store in the snapshot
+
+struct I2CInitWrite {
+  uint8_t reg;
+  uint8_t value;
+};
+
+// Decode a burst (len bytes) into values, cal = calibration bytes read at init
+typedef void (*I2CDecodeFn)(const uint8_t* raw, uint8_t len, const uint8_t* cal, float* out);
+
+struct I2CDriver {
+  const char* name;
+  const I2CInitWrite* init;  // Written in order after power-up or a failure
+  uint8_t initCount;
+  uint16_t initDelayMs;      // Settling time after the init writes
+  int16_t calReg;            // Calibration block, -1 = none
+  uint8_t calLen;
+  int16_t burstReg;          // First register, -1 = the channel's "reg"
+  uint8_t burstLen;          // Bytes, 0 = the channel's "length"
+  uint8_t valueCount;        // Values per read, 0 = one per 2 bytes read
+  I2CDecodeFn decode;
+};
+
+// ========== BUILT-IN DRIVERS ==========
+
+static inline int16_t i2cBE16(const uint8_t* p) {
+  return (int16_t)((p[0] << 8) | p[1]);
+}
+
+static inline uint16_t i2cLE16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// "raw": unsigned big-endian value of 1-4 bytes (the generic read)
+inline void decodeRawI2C(const uint8_t* raw, uint8_t len, const uint8_t* cal, float* out) {
+  (void)cal;
+  uint32_t v = 0;
+  for (uint8_t i = 0; i < len; i++) v = (v << 8) | raw[i];
+  out[0] = v;
+}
+
+// "raw16": signed big-endian 16-bit words, one value each
+inline void decodeRaw16I2C(const uint8_t* raw, uint8_t len, const uint8_t* cal, float* out) {
+  (void)cal;
+  for (uint8_t i = 0; i + 1 < len; i += 2) out[i / 2] = i2cBE16(raw + i);
+}
+
+// MPU-6050 at +-2 g / +-250 dps: ax, ay, az (g), gx, gy, gz (dps), temp (C)
+inline void decodeMPU6050(const uint8_t* raw, uint8_t len, const uint8_t* cal, float* out) {
+  (void)len;
+  (void)cal;
+  for (int i = 0; i < 3; i++) out[i] = i2cBE16(raw + 2 * i) / 16384.0f;
+  for (int i = 0; i < 3; i++) out[3 + i] = i2cBE16(raw + 8 + 2 * i) / 131.0f;
+  out[6] = i2cBE16(raw + 6) / 340.0f + 36.53f;
+}
+
+// BMP280: temperature (C), pressure (hPa), Bosch integer compensation
+inline void decodeBMP280(const uint8_t* raw, uint8_t len, const uint8_t* cal, float* out) {
+  (void)len;
+  int32_t adcP = ((int32_t)raw[0] << 12) | ((int32_t)raw[1] << 4) | (raw[2] >> 4);
+  int32_t adcT = ((int32_t)raw[3] << 12) | ((int32_t)raw[4] << 4) | (raw[5] >> 4);
+
+  int32_t t1 = i2cLE16(cal);
+  int32_t t2 = (int16_t)i2cLE16(cal + 2);
+  int32_t t3 = (int16_t)i2cLE16(cal + 4);
+  int32_t var1 = ((((adcT >> 3) - (t1 << 1))) * t2) >> 11;
+  int32_t var2 = (((((adcT >> 4) - t1) * ((adcT >> 4) - t1)) >> 12) * t3) >> 14;
+  int32_t tFine = var1 + var2;
+  out[0] = ((tFine * 5 + 128) >> 8) / 100.0f;
+
+  int64_t p1 = i2cLE16(cal + 6);
+  int64_t p[9];
+  for (int i = 2; i <= 9; i++) p[i - 1] = (int16_t)i2cLE16(cal + 6 + 2 * (i - 1));
+  int64_t v1 = (int64_t)tFine - 128000;
+  int64_t v2 = v1 * v1 * p[5];
+  v2 += (v1 * p[4]) << 17;
+  v2 += p[3] << 35;
+  v1 = ((v1 * v1 * p[2]) >> 8) + ((v1 * p[1]) << 12);
+  v1 = ((((int64_t)1) << 47) + v1) * p1 >> 33;
+  if (v1 == 0) {
+    out[1] = 0;  // Uncalibrated device, avoid dividing by zero
+    return;
+  }
+  int64_t pa = 1048576 - adcP;
+  pa = (((pa << 31) - v2) * 3125) / v1;
+  v1 = (p[8] * (pa >> 13) * (pa >> 13)) >> 25;
+  v2 = (p[7] * pa) >> 19;
+  pa = ((pa + v1 + v2) >> 8) + (p[6] << 4);  // Pa in Q24.8
+  out[1] = pa / 25600.0f;
+}
+
+static const I2CInitWrite MPU6050_INIT[] = {
+  {0x6B, 0x01},  // PWR_MGMT_1: wake, PLL on gyro X
+  {0x1A, 0x03},  // CONFIG: 44 Hz low-pass
+  {0x1B, 0x00},  // GYRO_CONFIG: +-250 dps
+  {0x1C, 0x00},  // ACCEL_CONFIG: +-2 g
+};
+
+static const I2CInitWrite BMP280_INIT[] = {
+  {0xF5, 0x10},  // config: 0.5 ms standby, IIR filter 16
+  {0xF4, 0x57},  // ctrl_meas: T x2, P x16, normal mode
+};
+
+static const I2CDriver I2C_DRIVER_RAW = {"raw", nullptr, 0, 0, -1, 0, -1, 0, 1, decodeRawI2C};
+static const I2CDriver I2C_DRIVER_RAW16 = {"raw16", nullptr, 0, 0, -1, 0, -1, 0, 0, decodeRaw16I2C};
+static const I2CDriver I2C_DRIVER_MPU6050 = {"mpu6050", MPU6050_INIT, 4, 0, -1, 0,
+                                             0x3B, 14, 7, decodeMPU6050};
+static const I2CDriver I2C_DRIVER_BMP280 = {"bmp280", BMP280_INIT, 2, 0, 0x88, 24,
+                                            0xF7, 6, 2, decodeBMP280};
+
+// ========== REGISTRY ==========
+
+struct I2CDriverRegistry {
+  const I2CDriver* drivers[I2C_MAX_DRIVERS];
+  uint8_t count;
+};
+
+inline I2CDriverRegistry& i2cDriverRegistry() {
+  static I2CDriverRegistry registry = {
+    {&I2C_DRIVER_RAW, &I2C_DRIVER_RAW16, &I2C_DRIVER_MPU6050, &I2C_DRIVER_BMP280}, 4
+  };
+  return registry;
+}
+
+// Add or replace (same name) a driver; false if the registry is full
+inline bool registerI2CDriver(const I2CDriver* driver) {
+  I2CDriverRegistry& r = i2cDriverRegistry();
+  for (uint8_t i = 0; i < r.count; i++) {
+    if (strcmp(r.drivers[i]->name, driver->name) == 0) {
+      r.drivers[i] = driver;
+      return true;
+    }
+  }
+  if (r.count >= I2C_MAX_DRIVERS) return false;
+  r.drivers[r.count++] = driver;
+  return true;
+}
+
+// nullptr or "" is the generic "raw" driver; unknown names return nullptr
+inline const I2CDriver* findI2CDriver(const char* name) {
+  if (!name || !*name) return &I2C_DRIVER_RAW;
+  I2CDriverRegistry& r = i2cDriverRegistry();
+  for (uint8_t i = 0; i < r.count; i++) {
+    if (strcmp(r.drivers[i]->name, name) == 0) return r.drivers[i];
+  }
+  return nullptr;
+}
+
+// Registry position of a built-in driver, -1 for registered ones
+inline int i2cBuiltinDriverIndex(const char* name) {
+  const I2CDriver* driver = findI2CDriver(name);
+  I2CDriverRegistry& r = i2cDriverRegistry();
+  for (uint8_t i = 0; i < I2C_BUILTIN_DRIVERS; i++) {
+    if (r.drivers[i] == driver) return i;
+  }
+  return -1;
+}
+
+// ========== PER-DEVICE STATE ==========
+
+// One per I2C channel: its resolved driver, burst geometry and whether
+// the init sequence has run since the device last failed
+class I2CDevice {
+private:
+  const I2CDriver* driver = &I2C_DRIVER_RAW;
+  uint8_t address = 0;
+  int16_t reg = -1;
+  uint8_t burstLen = 2;
+  uint8_t values = 1;
+  bool ready = false;
+  uint8_t cal[I2C_MAX_CALIBRATION];
+
+  SampleStatus initialize(I2CEngine& engine, uint32_t nowMs) {
+    for (uint8_t i = 0; i < driver->initCount; i++) {
+      SampleStatus s = engine.writeRegister(address, driver->init[i].reg,
+                                            driver->init[i].value, nowMs);
+      if (s != SAMPLE_OK) return s;
+    }
+    if (driver->initDelayMs) delay(driver->initDelayMs);
+    if (driver->calReg >= 0) {
+      SampleStatus s = engine.readBytes(address, driver->calReg, cal, driver->calLen, nowMs);
+      if (s != SAMPLE_OK) return s;
+    }
+    ready = true;
+    return SAMPLE_OK;
+  }
+
+public:
+  // Fix the burst for this channel; keeps init state if nothing changed
+  void resolve(const I2CDriver* d, uint8_t addr, int channelReg, uint8_t channelLength) {
+    if (d != driver || addr != address) ready = false;
+    driver = d;
+    address = addr;
+    reg = d->burstReg >= 0 ? d->burstReg : channelReg;
+    if (d->burstLen) {
+      burstLen = d->burstLen;
+    } else if (d == &I2C_DRIVER_RAW) {
+      burstLen = channelLength ? constrain(channelLength, 1, 4) : 2;
+    } else {
+      burstLen = channelLength ? constrain(channelLength, 2, I2C_MAX_BURST) & ~1 : 2;
+    }
+    burstLen = std::min<uint8_t>(burstLen, I2C_MAX_BURST);
+    values = d->valueCount ? d->valueCount : burstLen / 2;
+    values = constrain(values, 1, I2C_MAX_VALUES);
+  }
+
+  // One burst read (after the init sequence if it hasn't run), decoded
+  // into valueCount() values. A failure re-runs init on the next read, so
+  // a power-cycled sensor is configured again.
+  SampleStatus read(I2CEngine& engine, float* out, uint32_t nowMs) {
+    if (!ready) {
+      SampleStatus s = initialize(engine, nowMs);
+      if (s != SAMPLE_OK) return s;
+    }
+    uint8_t raw[I2C_MAX_BURST];
+    SampleStatus s = engine.readBytes(address, reg, raw, burstLen, nowMs);
+    if (s != SAMPLE_OK) {
+      if (s != SAMPLE_SKIPPED) ready = false;
+      return s;
+    }
+    driver->decode(raw, burstLen, cal, out);
+    return SAMPLE_OK;
+  }
+
+  const I2CDriver* getDriver() const {
+    return driver;
+  }
+
+  uint8_t getAddress() const {
+    return address;
+  }
+
+  uint8_t valueCount() const {
+    return values;
+  }
+
+  bool isReady() const {
+    return ready;
+  }
+};
@@ -0,0 +1,187 @@
+/*
+ * I2C transaction engine
+ * One register-addressed read per device (write register, repeated start,
+ * read) with no separate presence probe. Transaction results drive a
+ * per-address health record; failing addresses back off exponentially so
+ * a dead sensor stops costing bus time on every scan.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <algorithm>
+#include "ScanPlan.h"
+
+#define I2C_DEFAULT_CLOCK 100000
+#define I2C_BACKOFF_BASE_MS 100  // First retry delay after a failure
+#define I2C_BACKOFF_MAX_MS 10000 // Retry at least this often
+#define I2C_PROBE_CLOCK 400000   // Discovery probes run at least this fast
+#define I2C_PROBE_TIMEOUT_MS 2   // Per probe, instead of the 50 ms default
+
+struct I2CDeviceHealth {
+  uint8_t failures;      // Consecutive failed transactions
+  uint32_t retryAtMs;    // Skipped until this time while failing
+  uint32_t okCount;
+  uint32_t errorCount;
+  uint32_t retryCount;   // Transactions tried again after a failure
+};
+
+// endTransmission() result: 2 = address NACK, 5 = timeout (ESP32 core)
+inline SampleStatus i2cStatus(uint8_t code) {
+  switch (code) {
+    case 0:  return SAMPLE_OK;
+    case 2:  return SAMPLE_NO_DEVICE;
+    case 5:  return SAMPLE_TIMEOUT;
+    default: return SAMPLE_ERROR;
+  }
+}
+
+class I2CEngine {
+private:
+  I2CDeviceHealth health[128];  // Indexed by 7-bit address
+  uint32_t clockHz = I2C_DEFAULT_CLOCK;
+  uint32_t sessionBusUs = 0;
+  uint32_t lastScanBusUs = 0;
+  uint16_t sessionTransactions = 0;
+  uint16_t lastScanTransactions = 0;
+  uint16_t savedTimeoutMs = 0;
+
+  void recordResult(uint8_t address, bool ok, uint32_t nowMs) {
+    I2CDeviceHealth& h = health[address & 0x7F];
+    if (h.failures > 0) h.retryCount++;
+    if (ok) {
+      h.failures = 0;
+      h.retryAtMs = 0;
+      h.okCount++;
+      return;
+    }
+    h.errorCount++;
+    if (h.failures < 31) h.failures++;
+    uint32_t delayMs = (uint32_t)I2C_BACKOFF_BASE_MS << std::min(h.failures - 1, 7);
+    h.retryAtMs = nowMs + std::min(delayMs, (uint32_t)I2C_BACKOFF_MAX_MS);
+  }
+
+public:
+  I2CEngine() {
+    resetHealth();
+  }
+
+  void setClock(uint32_t hz) {
+    clockHz = hz ? hz : I2C_DEFAULT_CLOCK;
+    Wire.setClock(clockHz);
+  }
+
+  uint32_t getClock() const {
+    return clockHz;
+  }
+
+  void resetHealth() {
+    memset(health, 0, sizeof(health));
+  }
+
+  const I2CDeviceHealth& getHealth(uint8_t address) const {
+    return health[address & 0x7F];
+  }
+
+  // True while a failing address is waiting out its backoff
+  bool isBackedOff(uint8_t address, uint32_t nowMs) const {
+    const I2CDeviceHealth& h = health[address & 0x7F];
+    return h.failures > 0 && (int32_t)(h.retryAtMs - nowMs) > 0;
+  }
+
+  // Read len bytes starting at reg (reg < 0: read from the current pointer).
+  // One bus transaction; an absent device fails on its address NACK.
+  SampleStatus readBytes(uint8_t address, int reg, uint8_t* buf, uint8_t len, uint32_t nowMs) {
+    if (isBackedOff(address, nowMs)) return SAMPLE_SKIPPED;
+
+    uint32_t start = micros();
+    SampleStatus status = SAMPLE_OK;
+    if (reg >= 0) {
+      Wire.beginTransmission(address);
+      Wire.write((uint8_t)reg);
+      status = i2cStatus(Wire.endTransmission(false));  // Repeated start, keep the bus
+    }
+    if (status == SAMPLE_OK) {
+      bool ok = Wire.requestFrom(address, (size_t)len) == len;
+      for (uint8_t i = 0; i < len; i++) {
+        buf[i] = ok ? Wire.read() : 0;
+      }
+      if (!ok) status = SAMPLE_NO_DEVICE;
+    }
+    sessionBusUs += micros() - start;
+    sessionTransactions++;
+
+    recordResult(address, status == SAMPLE_OK, nowMs);
+    return status;
+  }
+
+  // Write one register (device setup). Counts toward health like a read.
+  SampleStatus writeRegister(uint8_t address, uint8_t reg, uint8_t value, uint32_t nowMs) {
+    if (isBackedOff(address, nowMs)) return SAMPLE_SKIPPED;
+
+    uint32_t start = micros();
+    Wire.beginTransmission(address);
+    Wire.write(reg);
+    Wire.write(value);
+    SampleStatus status = i2cStatus(Wire.endTransmission());
+    sessionBusUs += micros() - start;
+    sessionTransactions++;
+
+    recordResult(address, status == SAMPLE_OK, nowMs);
+    return status;
+  }
+
+  // Big-endian unsigned value of 1-4 bytes
+  SampleStatus readValue(uint8_t address, int reg, uint8_t len, float& value, uint32_t nowMs) {
+    uint8_t buf[4];
+    len = constrain(len, 1, 4);
+    SampleStatus status = readBytes(address, reg, buf, len, nowMs);
+    if (status != SAMPLE_OK) return status;
+    uint32_t raw = 0;
+    for (uint8_t i = 0; i < len; i++) raw = (raw << 8) | buf[i];
+    value = raw;
+    return SAMPLE_OK;
+  }
+
+  // Raise the clock and shorten the timeout for a run of probe() calls
+  void beginProbes() {
+    savedTimeoutMs = Wire.getTimeOut();
+    Wire.setClock(std::max(clockHz, (uint32_t)I2C_PROBE_CLOCK));
+    Wire.setTimeOut(I2C_PROBE_TIMEOUT_MS);
+  }
+
+  void endProbes() {
+    Wire.setClock(clockHz);
+    Wire.setTimeOut(savedTimeoutMs);
+  }
+
+  // Address-only write; true if a device ACKs. Doesn't touch device health.
+  bool probe(uint8_t address) {
+    uint32_t start = micros();
+    Wire.beginTransmission(address);
+    bool ack = Wire.endTransmission() == 0;
+    sessionBusUs += micros() - start;
+    sessionTransactions++;
+    return ack;
+  }
+
+  // Bracket a scan's queued reads to measure bus time per scan
+  void beginSession() {
+    sessionBusUs = 0;
+    sessionTransactions = 0;
+  }
+
+  void endSession() {
+    lastScanBusUs = sessionBusUs;
+    lastScanTransactions = sessionTransactions;
+  }
+
+  uint32_t getLastScanBusTimeUs() const {
+    return lastScanBusUs;
+  }
+
+  uint16_t getLastScanTransactions() const {
+    return lastScanTransactions;
+  }
+};
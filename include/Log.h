@@ -0,0 +1,229 @@
+/*
+ * Logging with compile-time levels and deferred hot-path events
+ *
+ * LOG_ERROR/LOG_WARN/LOG_INFO/LOG_DEBUG format immediately and are meant for
+ * setup and config messages. LOG_EVENT_* record a 16-byte binary entry
+ * (event id, channel, one int, one float) into a ring; the text is only
+ * produced later by eventLog.flush() on a low-priority task. Levels above
+ * LOG_LEVEL compile to nothing. A full or contended ring drops the entry
+ * and counts it, so logging never waits.
+ *
+ * Set the level with -DLOG_LEVEL=LOG_LEVEL_INFO (default: LOG_LEVEL_DEBUG).
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include "SampleRing.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+#define LOG_RING_SIZE 256  // Entries, 16 bytes each
+
+// Hot-path events. Every format takes (int channel, int arg, double value)
+// in that order; formats may ignore trailing arguments.
+enum LogEventId : uint8_t {
+  EV_READ_DIGITAL = 0,
+  EV_READ_ANALOG,
+  EV_READ_ONEWIRE,
+  EV_READ_SPI,
+  EV_READ_I2C,
+  EV_CHANNEL_MISSING,
+  EV_NOT_READY,
+  EV_NO_DEVICE,
+  EV_I2C_ERROR,
+  EV_I2C_BACKOFF,
+  EV_READ_COUNTER,
+  EV_READ_FREQUENCY,
+  EV_READ_DUTY,
+  EV_READ_TIMEOUT,
+  EV_COUNT
+};
+
+inline const char* logEventFormat(uint8_t id) {
+  static const char* const formats[EV_COUNT] = {
+    "Channel %d (Digital Pin %d): %.0f\n",
+    "Channel %d (Analog Pin %d): %.0f\n",
+    "Channel %d (One-Wire Pin %d): %.2f C\n",
+    "Channel %d (SPI CS Pin %d): %.0f\n",
+    "Channel %d (I2C 0x%02X): %.0f\n",
+    "Channel %d is not active or doesn't exist\n",
+    "Channel %d (Pin %d): No reading yet\n",
+    "Channel %d (Pin %d): No device found\n",
+    "I2C error on Channel %d (0x%02X)\n",
+    "I2C Channel %d (0x%02X) backing off after errors\n",
+    "Channel %d (Counter Pin %d): %.0f edges\n",
+    "Channel %d (Frequency Pin %d): %.2f Hz\n",
+    "Channel %d (Duty Pin %d): %.1f %%\n",
+    "Channel %d (Pin/Address %d): Timed out\n",
+  };
+  return id < EV_COUNT ? formats[id] : "Unknown log event %d %d %f\n";
+}
+
+struct LogEntry {
+  uint32_t timestampUs;
+  uint8_t id;        // LogEventId
+  uint8_t level;
+  int16_t channel;
+  int32_t arg;
+  float value;
+};
+
+class EventLog {
+private:
+  SpscRing<LogEntry> ring;
+  std::atomic_flag producerBusy = ATOMIC_FLAG_INIT;  // Lets several tasks share the ring
+  std::atomic<uint32_t> dropped{0};
+  std::atomic<bool> running{false};
+
+#if defined(ESP32)
+  TaskHandle_t handle = nullptr;
+  std::atomic<bool> exited{true};
+
+  static void taskEntry(void* arg) {
+    EventLog* self = (EventLog*)arg;
+    while (self->running.load()) {
+      self->flush(Serial, LOG_RING_SIZE);
+      vTaskDelay(pdMS_TO_TICKS(20));
+    }
+    self->exited.store(true);
+    vTaskDelete(nullptr);
+  }
+#else
+  std::thread worker;
+
+  void threadLoop() {
+    while (running.load()) {
+      flush(Serial, LOG_RING_SIZE);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+  }
+#endif
+
+public:
+  EventLog() {
+    ring.begin(LOG_RING_SIZE);
+  }
+
+  ~EventLog() {
+    stop();
+  }
+
+  // Record an event; never blocks, drops and counts instead
+  void record(uint8_t level, uint8_t id, int channel, int32_t arg, float value) {
+    if (producerBusy.test_and_set(std::memory_order_acquire)) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    LogEntry e = {(uint32_t)micros(), id, level, (int16_t)channel, arg, value};
+    if (!ring.push(e)) dropped.fetch_add(1, std::memory_order_relaxed);
+    producerBusy.clear(std::memory_order_release);
+  }
+
+  // Format up to max queued events; call from one consumer only
+  size_t flush(Print& out, size_t max) {
+    LogEntry batch[16];
+    size_t total = 0;
+    while (total < max) {
+      size_t n = ring.drain(batch, std::min(max - total, sizeof(batch) / sizeof(batch[0])));
+      if (n == 0) break;
+      for (size_t i = 0; i < n; i++) {
+        out.printf(logEventFormat(batch[i].id), batch[i].channel, (int)batch[i].arg,
+                   (double)batch[i].value);
+      }
+      total += n;
+    }
+    return total;
+  }
+
+  // Flush from a background task so formatting never runs on the read path
+  bool startTask(int core = 1, int priority = 1) {
+    if (running.exchange(true)) return false;
+#if defined(ESP32)
+    exited.store(false);
+    if (xTaskCreatePinnedToCore(taskEntry, "logflush", 3072, this, priority, &handle,
+                                core) != pdPASS) {
+      running.store(false);
+      exited.store(true);
+      return false;
+    }
+#else
+    (void)core;
+    (void)priority;
+    worker = std::thread(&EventLog::threadLoop, this);
+#endif
+    return true;
+  }
+
+  void stop() {
+    if (!running.exchange(false)) return;
+#if defined(ESP32)
+    while (!exited.load()) vTaskDelay(1);
+    handle = nullptr;
+#else
+    if (worker.joinable()) worker.join();
+#endif
+  }
+
+  size_t pending() const {
+    return ring.size();
+  }
+
+  uint32_t droppedCount() const {
+    return dropped.load(std::memory_order_relaxed);
+  }
+};
+
+extern EventLog eventLog;
+
+// ========== LEVEL MACROS ==========
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(fmt, ...) Serial.printf(fmt "\n", ##__VA_ARGS__)
+#define LOG_EVENT_ERROR(id, ch, arg, val) eventLog.record(LOG_LEVEL_ERROR, id, ch, arg, val)
+#else
+#define LOG_ERROR(fmt, ...) do {} while (0)
+#define LOG_EVENT_ERROR(id, ch, arg, val) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(fmt, ...) Serial.printf(fmt "\n", ##__VA_ARGS__)
+#define LOG_EVENT_WARN(id, ch, arg, val) eventLog.record(LOG_LEVEL_WARN, id, ch, arg, val)
+#else
+#define LOG_WARN(fmt, ...) do {} while (0)
+#define LOG_EVENT_WARN(id, ch, arg, val) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(fmt, ...) Serial.printf(fmt "\n", ##__VA_ARGS__)
+#define LOG_EVENT_INFO(id, ch, arg, val) eventLog.record(LOG_LEVEL_INFO, id, ch, arg, val)
+#else
+#define LOG_INFO(fmt, ...) do {} while (0)
+#define LOG_EVENT_INFO(id, ch, arg, val) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(fmt, ...) Serial.printf(fmt "\n", ##__VA_ARGS__)
+#define LOG_EVENT_DEBUG(id, ch, arg, val) eventLog.record(LOG_LEVEL_DEBUG, id, ch, arg, val)
+#else
+#define LOG_DEBUG(fmt, ...) do {} while (0)
+#define LOG_EVENT_DEBUG(id, ch, arg, val) do {} while (0)
+#endif
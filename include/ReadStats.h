@@ -0,0 +1,192 @@
+/*
+ * Always-on read instrumentation
+ * Every channel read is timed with the CPU cycle counter and counted per
+ * channel and per bus: reads by SampleStatus, I2C retries, total and
+ * worst time, and a log2 latency histogram (<1 us, 1-2 us, 2-4 us, ...,
+ * >= 16 ms). Whole scans are timed the same way; bus time over the time
+ * since reset() gives each bus's utilization.
+ * Counters are plain integers updated by the task that scans. A dump or
+ * reset from the other core may see one read half-counted.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <string.h>
+#include <vector>
+#include "ScanPlan.h"
+
+#if !defined(ESP32)
+#include <chrono>
+#endif
+
+#define LATENCY_BUCKETS 16
+
+// CPU cycles, wrapping; only differences are meaningful
+inline uint32_t cycleCount() {
+#if defined(ESP32)
+  return ESP.getCycleCount();
+#else
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline uint32_t cyclesPerUs() {
+#if defined(ESP32)
+  return ESP.getCpuFreqMHz();
+#else
+  return 1000;  // Host cycles are nanoseconds
+#endif
+}
+
+// Count, total, worst and histogram of one kind of operation
+struct LatencyStats {
+  uint32_t count;
+  uint32_t maxCycles;
+  uint64_t cycles;
+  uint32_t histogram[LATENCY_BUCKETS];  // Bucket b: [2^(b-1), 2^b) us, 0: < 1 us
+
+  void add(uint32_t c, uint32_t perUs) {
+    count++;
+    cycles += c;
+    if (c > maxCycles) maxCycles = c;
+    uint32_t us = c / perUs;
+    uint32_t b = us ? 32 - __builtin_clz(us) : 0;
+    histogram[b < LATENCY_BUCKETS ? b : LATENCY_BUCKETS - 1]++;
+  }
+};
+
+struct ReadStats {
+  LatencyStats time;
+  uint32_t status[SAMPLE_STATUS_COUNT];  // Reads by SampleStatus
+  uint32_t retries;                      // I2C reads of a device that had failed
+  uint8_t bus;                           // ScanBus of the last read
+};
+
+class ReadStatsCollector {
+private:
+  std::vector<ReadStats> channels;  // By channel number
+  ReadStats buses[BUS_COUNT];
+  LatencyStats scans;
+  uint32_t perUs = 1;
+  uint32_t resetMs = 0;
+  bool enabled = true;
+
+  static void printLatency(Print& out, const LatencyStats& s, uint32_t perUs) {
+    out.printf("\"count\":%lu,\"mean_us\":%.2f,\"max_us\":%.2f,\"hist\":[",
+               (unsigned long)s.count, s.count ? (double)s.cycles / perUs / s.count : 0.0,
+               (double)s.maxCycles / perUs);
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+      out.printf(b ? ",%lu" : "%lu", (unsigned long)s.histogram[b]);
+    }
+    out.print("]");
+  }
+
+  static void printStatus(Print& out, const ReadStats& s) {
+    for (int k = 0; k < SAMPLE_STATUS_COUNT; k++) {
+      out.printf(",\"%s\":%lu", statusName(k), (unsigned long)s.status[k]);
+    }
+    out.printf(",\"retries\":%lu", (unsigned long)s.retries);
+  }
+
+public:
+  ReadStatsCollector() {
+    reset();
+  }
+
+  // Room for channel numbers below count; keeps existing counts
+  void configure(size_t count) {
+    channels.resize(count, ReadStats());
+  }
+
+  void reset() {
+    for (auto& c : channels) c = ReadStats();
+    for (auto& b : buses) b = ReadStats();
+    scans = LatencyStats();
+    perUs = cyclesPerUs();
+    if (perUs == 0) perUs = 1;
+    resetMs = millis();
+  }
+
+  void setEnabled(bool on) {
+    enabled = on;
+  }
+
+  bool isEnabled() const {
+    return enabled;
+  }
+
+  void recordRead(int channel, ScanBus bus, uint8_t status, uint32_t cycles, bool retry) {
+    ReadStats& b = buses[bus];
+    b.time.add(cycles, perUs);
+    b.status[status < SAMPLE_STATUS_COUNT ? status : (uint8_t)SAMPLE_ERROR]++;
+    b.retries += retry;
+    if (channel < 0 || (size_t)channel >= channels.size()) return;
+    ReadStats& c = channels[channel];
+    c.time.add(cycles, perUs);
+    c.status[status < SAMPLE_STATUS_COUNT ? status : (uint8_t)SAMPLE_ERROR]++;
+    c.retries += retry;
+    c.bus = bus;
+  }
+
+  void recordScan(uint32_t cycles) {
+    scans.add(cycles, perUs);
+  }
+
+  // Zeroed stats for a channel that was never read
+  const ReadStats& getChannel(int channel) const {
+    static const ReadStats none = ReadStats();
+    return channel >= 0 && (size_t)channel < channels.size() ? channels[channel] : none;
+  }
+
+  const ReadStats& getBus(ScanBus bus) const {
+    return buses[bus];
+  }
+
+  const LatencyStats& getScans() const {
+    return scans;
+  }
+
+  // Fraction of the time since reset() spent reading this bus
+  float utilization(ScanBus bus) const {
+    uint32_t elapsedMs = millis() - resetMs;
+    if (elapsedMs == 0) return 0;
+    return (double)buses[bus].time.cycles / perUs / (elapsedMs * 1000.0);
+  }
+
+  uint32_t getElapsedMs() const {
+    return millis() - resetMs;
+  }
+
+  // One line of JSON: scans, buses, then every channel that was read
+  void printJson(Print& out) const {
+    out.printf("{\"elapsed_ms\":%lu,\"cpu_mhz\":%lu,\"scans\":{",
+               (unsigned long)getElapsedMs(), (unsigned long)perUs);
+    printLatency(out, scans, perUs);
+    out.print("},\"buses\":[");
+    bool first = true;
+    for (int b = 0; b < BUS_COUNT; b++) {
+      if (buses[b].time.count == 0) continue;
+      out.printf("%s{\"bus\":\"%s\",\"utilization\":%.5f,", first ? "" : ",",
+                 busName((ScanBus)b), utilization((ScanBus)b));
+      printLatency(out, buses[b].time, perUs);
+      printStatus(out, buses[b]);
+      out.print("}");
+      first = false;
+    }
+    out.print("],\"channels\":[");
+    first = true;
+    for (size_t ch = 0; ch < channels.size(); ch++) {
+      const ReadStats& c = channels[ch];
+      if (c.time.count == 0) continue;
+      out.printf("%s{\"channel\":%u,\"bus\":\"%s\",", first ? "" : ",", (unsigned)ch,
+                 busName((ScanBus)c.bus));
+      printLatency(out, c.time, perUs);
+      printStatus(out, c);
+      out.print("}");
+      first = false;
+    }
+    out.print("]}\n");
+  }
+};
@@ -0,0 +1,67 @@
+/*
+ * Binary sample log format
+ * A log file is a sequence of 512-byte blocks. Each block carries a header,
+ * up to LOG_RECORDS_PER_BLOCK fixed-size records and a CRC32 over the rest
+ * of the block. A torn or corrupt block fails its CRC and is skipped, so a
+ * file cut short by power loss is still readable up to its last good block.
+ * Shared by the firmware writer and the host tools; plain C++ only.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LOG_BLOCK_SIZE 512
+#define LOG_MAGIC 0x474C534FUL  // "OSLG" little-endian
+#define LOG_VERSION 1
+#define LOG_RECORDS_PER_BLOCK 41
+
+// One sample, 12 bytes, little-endian
+struct LogRecord {
+  uint32_t timestampUs;
+  int16_t channel;
+  uint8_t status;    // SampleStatus
+  uint8_t sub;       // Value index within a multi-value channel, 0 before drivers
+  float value;
+};
+
+struct LogBlockHeader {
+  uint32_t magic;
+  uint32_t sequence;  // Increments per block across files, restarts each session
+  uint16_t count;     // Valid records in this block
+  uint16_t version;
+};
+
+struct LogBlock {
+  LogBlockHeader header;
+  LogRecord records[LOG_RECORDS_PER_BLOCK];
+  uint8_t pad[4];
+  uint32_t crc;       // CRC32 of every byte before this field
+};
+
+static_assert(sizeof(LogRecord) == 12, "LogRecord must stay 12 bytes");
+static_assert(sizeof(LogBlock) == LOG_BLOCK_SIZE, "LogBlock must fill one block");
+
+// CRC-32 (IEEE, reflected), nibble table to keep flash use small
+inline uint32_t logCrc32(const uint8_t* data, size_t len, uint32_t crc = 0) {
+  static const uint32_t table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc = (crc >> 4) ^ table[(crc ^ data[i]) & 0x0F];
+    crc = (crc >> 4) ^ table[(crc ^ (data[i] >> 4)) & 0x0F];
+  }
+  return ~crc;
+}
+
+inline uint32_t logBlockCrc(const LogBlock& block) {
+  return logCrc32((const uint8_t*)&block, offsetof(LogBlock, crc));
+}
+
+inline bool logBlockValid(const LogBlock& block) {
+  return block.header.magic == LOG_MAGIC && block.header.version == LOG_VERSION &&
+         block.header.count <= LOG_RECORDS_PER_BLOCK && block.crc == logBlockCrc(block);
+}
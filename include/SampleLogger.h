@@ -0,0 +1,326 @@
+/*
+ * Append-only binary sample logger for the SD card
+ * Records are packed into 512-byte blocks (see SampleLogFormat.h) inside
+ * two PSRAM banks. While one bank fills, a background task writes the
+ * other to SD in one aligned write, so card latency never reaches the
+ * caller. Files rotate by size; every session starts a new file, so a tail
+ * torn by power loss is never appended to and readers just skip it.
+ * With a bus arbiter set, the card is written a few blocks per hold of the
+ * shared SPI bus so sensor reads can run in between.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <SD.h>
+#include <algorithm>
+#include <atomic>
+#include "SampleLogFormat.h"
+#include "SampleRing.h"
+#include "SpiEngine.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+#define LOG_DIR "/logs"
+#define LOG_BANK_BLOCKS 16                   // 8 KB per bank
+#define LOG_DEFAULT_MAX_FILE (64UL << 20)    // Rotate at 64 MB
+#define LOG_BUS_CHUNK_BLOCKS 4               // Blocks written per hold of the SPI bus
+
+class SampleLogger {
+private:
+  LogBlock* banks[2] = {nullptr, nullptr};
+  uint16_t bankBlocks = LOG_BANK_BLOCKS;
+  uint8_t activeBank = 0;
+  uint16_t activeBlock = 0;   // Block being filled in the active bank
+  uint32_t sequence = 0;
+
+  // Handoff to the flush task: bank index or -1, and how many blocks
+  std::atomic<int8_t> pendingBank{-1};
+  std::atomic<uint16_t> pendingBlocks{0};
+
+  File file;
+  SpiBusArbiter* bus = nullptr;  // Shared with SPI sensors, optional
+  uint32_t fileIndex = 0;
+  uint32_t fileBytes = 0;
+  uint32_t maxFileBytes = LOG_DEFAULT_MAX_FILE;
+
+  std::atomic<bool> running{false};
+  std::atomic<uint32_t> dropped{0};      // Records lost because both banks were busy
+  std::atomic<uint32_t> blocksWritten{0};
+  std::atomic<uint32_t> writeErrors{0};
+  std::atomic<uint32_t> maxFlushUs{0};
+
+#if defined(ESP32)
+  TaskHandle_t handle = nullptr;
+  std::atomic<bool> exited{true};
+#else
+  std::thread worker;
+#endif
+
+  // The card waits as long as it takes; sensors only hold the bus briefly
+  void lockBus() {
+    while (bus && !bus->lock(100)) {}
+  }
+
+  void unlockBus() {
+    if (bus) bus->unlock();
+  }
+
+  void fileName(uint32_t index, char* out, size_t len) const {
+    snprintf(out, len, LOG_DIR "/LOG%05lu.BIN", (unsigned long)index);
+  }
+
+  bool openNextFile() {
+    if (file) file.close();
+    char path[32];
+    // Never reuse a file from an earlier session, its tail may be torn
+    do {
+      fileIndex++;
+      fileName(fileIndex, path, sizeof(path));
+    } while (SD.exists(path));
+    file = SD.open(path, FILE_WRITE);
+    fileBytes = 0;
+    return (bool)file;
+  }
+
+  void sealBlock(LogBlock& block) {
+    block.header.magic = LOG_MAGIC;
+    block.header.version = LOG_VERSION;
+    block.header.sequence = sequence++;
+    memset(block.pad, 0, sizeof(block.pad));
+    // Unused record slots are zeroed so blocks are reproducible
+    memset(&block.records[block.header.count], 0,
+           (LOG_RECORDS_PER_BLOCK - block.header.count) * sizeof(LogRecord));
+    block.crc = logBlockCrc(block);
+  }
+
+  // Give the active bank to the flush task. Fails if it is still busy.
+  bool handOff() {
+    if (activeBlock == 0) return true;
+    if (pendingBank.load(std::memory_order_acquire) >= 0) return false;
+    pendingBlocks.store(activeBlock, std::memory_order_relaxed);
+    pendingBank.store(activeBank, std::memory_order_release);
+#if defined(ESP32)
+    if (handle) xTaskNotifyGive(handle);
+#endif
+    activeBank ^= 1;
+    activeBlock = 0;
+    banks[activeBank][0].header.count = 0;
+    return true;
+  }
+
+  void flushPending() {
+    int8_t bank = pendingBank.load(std::memory_order_acquire);
+    if (bank < 0) return;
+    uint32_t bytes = pendingBlocks.load(std::memory_order_relaxed) * LOG_BLOCK_SIZE;
+
+    uint32_t start = micros();
+    if (!file || fileBytes + bytes > maxFileBytes) {
+      lockBus();
+      openNextFile();
+      unlockBus();
+    }
+
+    bool ok = (bool)file;
+    const uint8_t* data = (const uint8_t*)banks[bank];
+    for (uint32_t done = 0; ok && done < bytes;) {
+      uint32_t n = std::min<uint32_t>(bytes - done, LOG_BUS_CHUNK_BLOCKS * LOG_BLOCK_SIZE);
+      lockBus();
+      ok = file.write(data + done, n) == n;
+      unlockBus();
+      done += n;
+    }
+    if (ok) {
+      lockBus();
+      file.flush();
+      unlockBus();
+      fileBytes += bytes;
+      blocksWritten.fetch_add(bytes / LOG_BLOCK_SIZE, std::memory_order_relaxed);
+    } else {
+      writeErrors.fetch_add(1, std::memory_order_relaxed);
+      lockBus();
+      if (file) file.close();  // Reopen a fresh file on the next flush
+      unlockBus();
+    }
+    uint32_t elapsed = micros() - start;
+    if (elapsed > maxFlushUs.load(std::memory_order_relaxed)) maxFlushUs.store(elapsed);
+
+    pendingBank.store(-1, std::memory_order_release);
+  }
+
+#if defined(ESP32)
+  static void taskEntry(void* arg) {
+    SampleLogger* self = (SampleLogger*)arg;
+    while (self->running.load()) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+      self->flushPending();
+    }
+    self->flushPending();
+    self->exited.store(true);
+    vTaskDelete(nullptr);
+  }
+#else
+  void threadLoop() {
+    while (running.load()) {
+      flushPending();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    flushPending();
+  }
+#endif
+
+public:
+  ~SampleLogger() {
+    end();
+  }
+
+  // Share the SD card's SPI bus with sensors; set before begin()
+  void setBusArbiter(SpiBusArbiter* arbiter) {
+    bus = arbiter;
+  }
+
+  // SD must already be initialized. Starts a new log file in LOG_DIR.
+  bool begin(uint32_t maxBytes = LOG_DEFAULT_MAX_FILE, uint16_t blocksPerBank = LOG_BANK_BLOCKS,
+             int core = 1, int priority = 2) {
+    if (running.load()) return false;
+    bankBlocks = blocksPerBank ? blocksPerBank : 1;
+    maxFileBytes = std::max(maxBytes, (uint32_t)bankBlocks * LOG_BLOCK_SIZE);
+    for (int i = 0; i < 2; i++) {
+      banks[i] = (LogBlock*)ringAlloc((size_t)bankBlocks * LOG_BLOCK_SIZE);
+      if (!banks[i]) {
+        end();
+        return false;
+      }
+    }
+    activeBank = 0;
+    activeBlock = 0;
+    banks[0][0].header.count = 0;
+    pendingBank.store(-1);
+
+    SD.mkdir(LOG_DIR);
+    fileIndex = 0;
+    if (!openNextFile()) {
+      end();
+      return false;
+    }
+
+    running.store(true);
+#if defined(ESP32)
+    exited.store(false);
+    if (xTaskCreatePinnedToCore(taskEntry, "logflush", 4096, this, priority, &handle,
+                                core) != pdPASS) {
+      running.store(false);
+      exited.store(true);
+      end();
+      return false;
+    }
+#else
+    (void)core;
+    (void)priority;
+    worker = std::thread(&SampleLogger::threadLoop, this);
+#endif
+    return true;
+  }
+
+  // Seal the partial block, write everything out and close the file
+  void end() {
+    if (running.load()) {
+      while (!sync()) delay(1);  // Wait for the other bank if it is still busy
+      while (pendingBank.load() >= 0) delay(1);
+      running.store(false);
+#if defined(ESP32)
+      if (handle) xTaskNotifyGive(handle);
+      while (!exited.load()) delay(1);
+      handle = nullptr;
+#else
+      if (worker.joinable()) worker.join();
+#endif
+    }
+    lockBus();
+    if (file) file.close();
+    unlockBus();
+    for (int i = 0; i < 2; i++) {
+      if (banks[i]) ringFree(banks[i]);
+      banks[i] = nullptr;
+    }
+  }
+
+  // Queue one record. Never touches the card; drops (and counts) if the
+  // active bank is full while the other is still being written.
+  bool append(uint32_t timestampUs, int16_t channel, uint8_t status, float value,
+              uint8_t sub = 0) {
+    if (!running.load(std::memory_order_relaxed)) return false;
+    if (activeBlock >= bankBlocks && !handOff()) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    LogBlock& block = banks[activeBank][activeBlock];
+    LogRecord& rec = block.records[block.header.count++];
+    rec.timestampUs = timestampUs;
+    rec.channel = channel;
+    rec.status = status;
+    rec.sub = sub;
+    rec.value = value;
+
+    if (block.header.count == LOG_RECORDS_PER_BLOCK) {
+      sealBlock(block);
+      activeBlock++;
+      if (activeBlock < bankBlocks) {
+        banks[activeBank][activeBlock].header.count = 0;
+      } else {
+        handOff();  // Start writing as soon as the bank is full
+      }
+    }
+    return true;
+  }
+
+  bool append(const Sample& s) {
+    return append(s.timestampUs, s.channel, s.status, s.value, s.sub);
+  }
+
+  // Seal the partially filled block and hand the bank to the flush task.
+  // Call periodically to bound how much a power loss can cost.
+  bool sync() {
+    if (!running.load()) return false;
+    if (activeBlock < bankBlocks) {
+      LogBlock& block = banks[activeBank][activeBlock];
+      if (block.header.count > 0) {
+        sealBlock(block);
+        activeBlock++;
+        if (activeBlock < bankBlocks) banks[activeBank][activeBlock].header.count = 0;
+      }
+    }
+    return handOff();
+  }
+
+  bool isRunning() const {
+    return running.load();
+  }
+
+  uint32_t getFileIndex() const {
+    return fileIndex;
+  }
+
+  uint32_t droppedCount() const {
+    return dropped.load(std::memory_order_relaxed);
+  }
+
+  uint32_t blocksWrittenCount() const {
+    return blocksWritten.load(std::memory_order_relaxed);
+  }
+
+  uint32_t writeErrorCount() const {
+    return writeErrors.load(std::memory_order_relaxed);
+  }
+
+  uint32_t maxFlushTimeUs() const {
+    return maxFlushUs.load(std::memory_order_relaxed);
+  }
+};
@@ -0,0 +1,144 @@
+/*
+ * Lock-free single-producer/single-consumer ring buffer
+ * The acquisition task pushes, one consumer drains. Storage goes to PSRAM
+ * when BOARD_HAS_PSRAM is set, otherwise to the regular heap.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+#include <type_traits>
+
+#if defined(ESP32)
+#include <esp_heap_caps.h>
+#endif
+
+// One timestamped reading, 12 bytes
+struct Sample {
+  uint32_t timestampUs;
+  int16_t channel;
+  uint8_t status;    // SampleStatus
+  uint8_t sub;       // Value index within a multi-value channel (I2C drivers)
+  float value;
+};
+
+// Large buffers go to PSRAM if the board has it
+inline void* ringAlloc(size_t bytes) {
+#if defined(ESP32) && defined(BOARD_HAS_PSRAM)
+  void* p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (p) return p;
+#endif
+  return malloc(bytes);
+}
+
+inline void ringFree(void* p) {
+  free(p);  // heap_caps memory is released with free() too
+}
+
+template <typename T>
+class SpscRing {
+  static_assert(std::is_trivially_copyable<T>::value, "ring storage is raw memory");
+
+private:
+  T* buffer = nullptr;
+  uint32_t mask = 0;
+
+  // Producer and consumer indices on separate cache lines
+  alignas(64) std::atomic<uint32_t> head{0};  // Written by producer only
+  alignas(64) std::atomic<uint32_t> tail{0};  // Written by consumer only
+
+  std::atomic<uint32_t> overruns{0};   // Pushes dropped because the ring was full
+  std::atomic<uint32_t> underruns{0};  // Pops that found the ring empty
+
+public:
+  SpscRing() {}
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  ~SpscRing() {
+    end();
+  }
+
+  // Capacity is rounded up to a power of two
+  bool begin(size_t capacity) {
+    end();
+    uint32_t size = 2;
+    while (size < capacity) size <<= 1;
+    buffer = (T*)ringAlloc(sizeof(T) * size);
+    if (!buffer) return false;
+    mask = size - 1;
+    head.store(0);
+    tail.store(0);
+    resetCounters();
+    return true;
+  }
+
+  void end() {
+    if (buffer) ringFree(buffer);
+    buffer = nullptr;
+    mask = 0;
+  }
+
+  // Producer side. Never blocks; a full ring counts an overrun and drops.
+  bool push(const T& item) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) > mask) {
+      overruns.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    buffer[h & mask] = item;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. An empty ring counts an underrun.
+  bool pop(T& item) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) {
+      underruns.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    item = buffer[t & mask];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Copies up to max items out in one pass.
+  size_t drain(T* out, size_t max) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t available = head.load(std::memory_order_acquire) - t;
+    if (available == 0) {
+      underruns.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+    }
+    size_t n = available < max ? available : max;
+    for (size_t i = 0; i < n; i++) {
+      out[i] = buffer[(t + i) & mask];
+    }
+    tail.store(t + n, std::memory_order_release);
+    return n;
+  }
+
+  size_t size() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+
+  size_t capacity() const {
+    return buffer ? mask + 1 : 0;
+  }
+
+  uint32_t overrunCount() const {
+    return overruns.load(std::memory_order_relaxed);
+  }
+
+  uint32_t underrunCount() const {
+    return underruns.load(std::memory_order_relaxed);
+  }
+
+  void resetCounters() {
+    overruns.store(0);
+    underruns.store(0);
+  }
+};
@@ -0,0 +1,149 @@
+/*
+ * Precomputed scan plan
+ * Active channels grouped by bus so a full scan does each bus's setup once
+ * and walks a flat array, filling a caller-owned ScanFrame.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "ChannelTable.h"
+
+enum SampleStatus : uint8_t {
+  SAMPLE_OK = 0,
+  SAMPLE_ERROR,      // Bus or device error
+  SAMPLE_NO_DEVICE,  // Nothing answered on the bus
+  SAMPLE_NOT_READY,  // No value available yet
+  SAMPLE_SKIPPED,    // Not read this scan
+  SAMPLE_TIMEOUT,    // The bus or device didn't answer in time
+  SAMPLE_STATUS_COUNT
+};
+
+inline const char* statusName(uint8_t status) {
+  switch (status) {
+    case SAMPLE_OK:        return "ok";
+    case SAMPLE_ERROR:     return "error";
+    case SAMPLE_NO_DEVICE: return "no_device";
+    case SAMPLE_NOT_READY: return "not_ready";
+    case SAMPLE_SKIPPED:   return "skipped";
+    case SAMPLE_TIMEOUT:   return "timeout";
+    default:               return "?";
+  }
+}
+
+enum ScanBus : uint8_t {
+  BUS_GPIO = 0,
+  BUS_ADC,
+  BUS_ONEWIRE,
+  BUS_SPI,
+  BUS_I2C,
+  BUS_COUNT
+};
+
+inline ScanBus busForType(ChannelType type) {
+  switch (type) {
+    case CH_ANALOG:  return BUS_ADC;
+    case CH_ONEWIRE: return BUS_ONEWIRE;
+    case CH_SPI:     return BUS_SPI;
+    case CH_I2C:     return BUS_I2C;
+    default:         return BUS_GPIO;
+  }
+}
+
+inline const char* busName(ScanBus bus) {
+  switch (bus) {
+    case BUS_GPIO:    return "GPIO";
+    case BUS_ADC:     return "ADC";
+    case BUS_ONEWIRE: return "ONEWIRE";
+    case BUS_SPI:     return "SPI";
+    case BUS_I2C:     return "I2C";
+    default:          return "?";
+  }
+}
+
+// Caller-owned structure-of-arrays for one scan's results.
+// Size it once with reserve(); scans never allocate.
+struct ScanFrame {
+  std::vector<int16_t> channel;
+  std::vector<float> value;
+  std::vector<uint32_t> timestampUs;
+  std::vector<uint8_t> status;  // SampleStatus
+  std::vector<uint8_t> sub;     // Value index within a multi-value channel, else 0
+  size_t count = 0;
+  // Span of the scan's reads, kept by filtering. GPIO and ADC channels
+  // are read first, between readStartUs and alignedEndUs.
+  uint32_t readStartUs = 0;
+  uint32_t alignedEndUs = 0;
+  uint32_t readEndUs = 0;
+
+  void reserve(size_t n) {
+    channel.assign(n, -1);
+    value.assign(n, 0);
+    timestampUs.assign(n, 0);
+    status.assign(n, SAMPLE_SKIPPED);
+    sub.assign(n, 0);
+    count = 0;
+  }
+
+  size_t capacity() const {
+    return value.size();
+  }
+};
+
+class ScanPlan {
+private:
+  std::vector<int16_t> channels;      // Channel numbers in scan order
+  std::vector<ChannelSlot> slots;     // Resolved slots, parallel to channels
+  uint16_t busStart[BUS_COUNT + 1];   // [busStart[b], busStart[b+1]) is bus b
+
+public:
+  ScanPlan() {
+    for (int b = 0; b <= BUS_COUNT; b++) busStart[b] = 0;
+  }
+
+  // Group every active channel in the table by bus, keeping channel order
+  void build(const ChannelTable& table) {
+    uint16_t counts[BUS_COUNT] = {0};
+    for (size_t ch = 0; ch < table.size(); ch++) {
+      const ChannelSlot* slot = table.find(ch);
+      if (slot) counts[busForType(slot->type)]++;
+    }
+
+    busStart[0] = 0;
+    for (int b = 0; b < BUS_COUNT; b++) busStart[b + 1] = busStart[b] + counts[b];
+
+    channels.assign(busStart[BUS_COUNT], -1);
+    slots.resize(busStart[BUS_COUNT]);
+
+    uint16_t next[BUS_COUNT];
+    for (int b = 0; b < BUS_COUNT; b++) next[b] = busStart[b];
+    for (size_t ch = 0; ch < table.size(); ch++) {
+      const ChannelSlot* slot = table.find(ch);
+      if (!slot) continue;
+      uint16_t i = next[busForType(slot->type)]++;
+      channels[i] = (int16_t)ch;
+      slots[i] = *slot;
+    }
+  }
+
+  size_t size() const {
+    return slots.size();
+  }
+
+  uint16_t begin(ScanBus bus) const {
+    return busStart[bus];
+  }
+
+  uint16_t end(ScanBus bus) const {
+    return busStart[bus + 1];
+  }
+
+  int16_t channelAt(size_t i) const {
+    return channels[i];
+  }
+
+  const ChannelSlot& slotAt(size_t i) const {
+    return slots[i];
+  }
+};
@@ -0,0 +1,177 @@
+/*
+ * SPI sensor reads and bus arbitration
+ * Sensors share the SPI bus with the SD card. SpiBusArbiter is a mutex
+ * (priority-inheriting on FreeRTOS) that the sample logger takes per
+ * chunk of card writes and a sensor batch takes once per scan, so neither
+ * can hold the bus for long. A sensor batch that can't get the bus within
+ * a short timeout skips its SPI reads instead of stalling the scan.
+ *
+ * SpiEngine reads each channel as one transfer of an optional command
+ * byte plus 1-4 response bytes, with the channel's own clock and mode.
+ * Consecutive channels with the same settings share one transaction.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <algorithm>
+#include <atomic>
+#include "ScanPlan.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#else
+#include <chrono>
+#include <mutex>
+#endif
+
+#define SPI_DEFAULT_CLOCK 1000000  // Hz, when a channel doesn't set one
+#define SPI_SENSOR_WAIT_MS 2       // Longest a scan waits for the SD card to yield the bus
+#define SPI_MAX_RESPONSE 4         // Response bytes per channel (big-endian value)
+
+class SpiBusArbiter {
+private:
+#if defined(ESP32)
+  SemaphoreHandle_t mutex = nullptr;
+#else
+  std::timed_mutex mutex;
+#endif
+  std::atomic<uint32_t> contended{0};  // Locks that had to wait
+  std::atomic<uint32_t> timeouts{0};   // Locks given up on
+  std::atomic<uint32_t> maxWaitUs{0};
+
+public:
+  SpiBusArbiter() {
+#if defined(ESP32)
+    mutex = xSemaphoreCreateMutex();
+#endif
+  }
+
+  // Take the bus, waiting at most timeoutMs. Returns false on timeout.
+  bool lock(uint32_t timeoutMs) {
+#if defined(ESP32)
+    if (xSemaphoreTake(mutex, 0) == pdTRUE) return true;
+    uint32_t start = micros();
+    bool ok = xSemaphoreTake(mutex, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+#else
+    if (mutex.try_lock()) return true;
+    uint32_t start = micros();
+    bool ok = mutex.try_lock_for(std::chrono::milliseconds(timeoutMs));
+#endif
+    uint32_t waited = micros() - start;
+    contended.fetch_add(1, std::memory_order_relaxed);
+    if (!ok) timeouts.fetch_add(1, std::memory_order_relaxed);
+    if (waited > maxWaitUs.load(std::memory_order_relaxed)) maxWaitUs.store(waited);
+    return ok;
+  }
+
+  void unlock() {
+#if defined(ESP32)
+    xSemaphoreGive(mutex);
+#else
+    mutex.unlock();
+#endif
+  }
+
+  uint32_t contendedCount() const {
+    return contended.load(std::memory_order_relaxed);
+  }
+
+  uint32_t timeoutCount() const {
+    return timeouts.load(std::memory_order_relaxed);
+  }
+
+  uint32_t getMaxWaitUs() const {
+    return maxWaitUs.load(std::memory_order_relaxed);
+  }
+
+  void resetStats() {
+    contended.store(0);
+    timeouts.store(0);
+    maxWaitUs.store(0);
+  }
+};
+
+class SpiEngine {
+private:
+  SpiBusArbiter* bus = nullptr;
+  bool inBatch = false;     // Between beginBatch() and endBatch()
+  bool busHeld = false;     // The batch got the bus
+  bool txOpen = false;      // A beginTransaction() is active
+  uint32_t txClock = 0;
+  uint8_t txMode = 0;
+  uint32_t transactions = 0;
+  uint32_t skippedBatches = 0;  // Batches that didn't get the bus in time
+
+  void openTransaction(uint32_t clockHz, uint8_t mode) {
+    if (txOpen && clockHz == txClock && mode == txMode) return;
+    if (txOpen) SPI.endTransaction();
+    SPI.beginTransaction(SPISettings(clockHz, MSBFIRST, mode));
+    txOpen = true;
+    txClock = clockHz;
+    txMode = mode;
+    transactions++;
+  }
+
+public:
+  void setArbiter(SpiBusArbiter* arbiter) {
+    bus = arbiter;
+  }
+
+  // Take the bus for a run of reads. False if the SD card kept it past
+  // SPI_SENSOR_WAIT_MS; reads in this batch then return SAMPLE_TIMEOUT.
+  bool beginBatch() {
+    inBatch = true;
+    busHeld = !bus || bus->lock(SPI_SENSOR_WAIT_MS);
+    if (!busHeld) skippedBatches++;
+    return busHeld;
+  }
+
+  void endBatch() {
+    if (txOpen) SPI.endTransaction();
+    txOpen = false;
+    if (busHeld && bus) bus->unlock();
+    busHeld = false;
+    inBatch = false;
+  }
+
+  // One channel: CS low, [command], length response bytes, CS high.
+  // Outside a batch this takes and releases the bus itself.
+  SampleStatus read(int csPin, uint32_t clockHz, uint8_t mode, uint8_t command,
+                    uint8_t length, float& value) {
+    bool single = !inBatch;
+    if (single) beginBatch();
+    if (!busHeld) {
+      if (single) endBatch();
+      return SAMPLE_TIMEOUT;
+    }
+
+    openTransaction(clockHz ? clockHz : SPI_DEFAULT_CLOCK, mode & 3);
+    uint8_t n = length ? std::min<uint8_t>(length, SPI_MAX_RESPONSE) : 1;
+    uint8_t skip = command ? 1 : 0;
+    uint8_t tx[SPI_MAX_RESPONSE + 1] = {command};
+    uint8_t rx[SPI_MAX_RESPONSE + 1];
+
+    digitalWrite(csPin, LOW);
+    SPI.transferBytes(tx, rx, n + skip);  // Whole frame through the FIFO at once
+    digitalWrite(csPin, HIGH);
+
+    uint32_t raw = 0;
+    for (uint8_t i = 0; i < n; i++) raw = (raw << 8) | rx[skip + i];
+    value = raw;
+
+    if (single) endBatch();
+    return SAMPLE_OK;
+  }
+
+  // beginTransaction() calls so far (settings changes, not channels)
+  uint32_t transactionCount() const {
+    return transactions;
+  }
+
+  uint32_t skippedBatchCount() const {
+    return skippedBatches;
+  }
+};
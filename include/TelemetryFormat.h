@@ -0,0 +1,488 @@
+/*
+ * Binary telemetry frame format
+ * Shared by the firmware encoder and host decoders (no Arduino includes).
+ *
+ * Wire: 0x00, COBS(payload + CRC32), 0x00. COBS leaves no zero bytes
+ * inside a frame, so a receiver resynchronises at the next 0x00 after
+ * any loss; the CRC (logCrc32, little-endian) rejects damaged frames.
+ * Log text printed between frames ends up as one rejected frame.
+ *
+ * Payload: version (u8), flags (u8, 0), sequence (u16), base timestamp
+ * (u32 us), sample count (u16), all little-endian, then per sample:
+ *   tag       u8: bits 0-2 status, bits 3-4 value kind, bit 5 sub byte
+ *             follows, bit 6 channel delta follows
+ *   channel   zigzag varint delta from the previous sample's channel, if
+ *             bit 6; otherwise the previous channel + 1 (the same channel
+ *             when sub > 0)
+ *   time      varint, microseconds since the previous sample (the base
+ *             timestamp for the first)
+ *   sub       u8, if bit 5
+ *   value     by kind, against the last value of the same channel and
+ *             sub earlier in this frame:
+ *             SAME  nothing, value unchanged
+ *             INT   zigzag varint delta of an integral value (from 0 when
+ *                   the last value wasn't integral or there was none)
+ *             XOR   varint of the float bits XOR the last value's bits
+ *             RAW   4 bytes, the float little-endian
+ * Frames don't depend on each other; a lost frame loses only its samples.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "SampleLogFormat.h"
+
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_HEADER_SIZE 10
+#define TELEMETRY_MAX_PAYLOAD 1024   // Payload bytes per frame, CRC excluded
+#define TELEMETRY_MAX_SAMPLE 15      // Worst-case encoded sample
+#define TELEMETRY_MAX_WIRE (TELEMETRY_MAX_PAYLOAD + 4 + (TELEMETRY_MAX_PAYLOAD + 4) / 254 + 3)
+#define TELEMETRY_CACHE_SIZE 256     // Last-value slots per frame (power of two)
+
+enum TelemetryValueKind : uint8_t {
+  TELEMETRY_SAME = 0,
+  TELEMETRY_INT,
+  TELEMETRY_XOR,
+  TELEMETRY_RAW
+};
+
+#define TELEMETRY_TAG_SUB 0x20
+#define TELEMETRY_TAG_CHANNEL 0x40
+
+// One decoded sample, same fields as a LogRecord
+struct TelemetrySample {
+  uint32_t timestampUs;
+  int16_t channel;
+  uint8_t sub;
+  uint8_t status;
+  float value;
+};
+
+// ========== PRIMITIVES ==========
+
+inline uint32_t telemetryZigzag(int32_t v) {
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+inline int32_t telemetryUnzigzag(uint32_t v) {
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+inline uint8_t telemetryVarintSize(uint32_t v) {
+  uint8_t n = 1;
+  while (v >= 0x80) {
+    v >>= 7;
+    n++;
+  }
+  return n;
+}
+
+inline uint8_t* telemetryPutVarint(uint8_t* p, uint32_t v) {
+  while (v >= 0x80) {
+    *p++ = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  *p++ = (uint8_t)v;
+  return p;
+}
+
+// nullptr if the varint runs past end or over 5 bytes
+inline const uint8_t* telemetryGetVarint(const uint8_t* p, const uint8_t* end, uint32_t& v) {
+  v = 0;
+  for (int shift = 0; shift < 35 && p < end; shift += 7) {
+    uint8_t b = *p++;
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return p;
+  }
+  return nullptr;
+}
+
+inline uint32_t telemetryFloatBits(float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, 4);
+  return bits;
+}
+
+inline float telemetryBitsFloat(uint32_t bits) {
+  float f;
+  memcpy(&f, &bits, 4);
+  return f;
+}
+
+// Integral and exactly representable, so an integer delta is lossless
+inline bool telemetryIsIntegral(float f) {
+  return f >= -16777216.0f && f <= 16777216.0f && f == (float)(int32_t)f &&
+         !(f == 0 && signbit(f));
+}
+
+// COBS: out needs len + len / 254 + 1 bytes. Returns the bytes written.
+inline size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+  uint8_t* code = out;
+  uint8_t* p = out + 1;
+  uint8_t run = 1;
+  for (size_t i = 0; i < len; i++) {
+    if (in[i] == 0) {
+      *code = run;
+      code = p++;
+      run = 1;
+      continue;
+    }
+    *p++ = in[i];
+    if (++run == 0xFF) {
+      *code = run;
+      code = p++;
+      run = 1;
+    }
+  }
+  *code = run;
+  return p - out;
+}
+
+// Decode one frame (no delimiters). Returns the bytes written, or 0 if the
+// input is malformed or longer than outSize.
+inline size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out, size_t outSize) {
+  size_t n = 0;
+  size_t i = 0;
+  while (i < len) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > len) return 0;
+    for (uint8_t k = 1; k < code; k++) {
+      if (n >= outSize) return 0;
+      out[n++] = in[i++];
+    }
+    if (code != 0xFF && i < len) {
+      if (n >= outSize) return 0;
+      out[n++] = 0;
+    }
+  }
+  return n;
+}
+
+// Last value per (channel, sub) within one frame. Slots are tagged with
+// the frame's generation instead of being cleared; a collision just
+// evicts, and the decoder makes the same choice, so both stay in step.
+class TelemetryValueCache {
+private:
+  struct Slot {
+    uint32_t bits;
+    int16_t channel;
+    uint8_t sub;
+    uint8_t valid;
+    uint16_t generation;
+  };
+
+  Slot slots[TELEMETRY_CACHE_SIZE];
+  uint16_t generation = 0;
+
+  Slot& slotFor(int16_t channel, uint8_t sub) {
+    uint32_t key = ((uint32_t)(uint16_t)channel * 8u + sub) * 2654435761u;
+    return slots[(key >> 24) & (TELEMETRY_CACHE_SIZE - 1)];
+  }
+
+public:
+  TelemetryValueCache() {
+    memset(slots, 0, sizeof(slots));
+  }
+
+  void newFrame() {
+    if (++generation == 0) {
+      memset(slots, 0, sizeof(slots));  // Tags wrapped, start clean
+      generation = 1;
+    }
+  }
+
+  bool find(int16_t channel, uint8_t sub, uint32_t& bits) {
+    Slot& s = slotFor(channel, sub);
+    if (!s.valid || s.generation != generation || s.channel != channel || s.sub != sub) {
+      return false;
+    }
+    bits = s.bits;
+    return true;
+  }
+
+  void store(int16_t channel, uint8_t sub, uint32_t bits) {
+    Slot& s = slotFor(channel, sub);
+    s.bits = bits;
+    s.channel = channel;
+    s.sub = sub;
+    s.valid = 1;
+    s.generation = generation;
+  }
+};
+
+// ========== ENCODER ==========
+
+class TelemetryEncoder {
+private:
+  uint8_t payload[TELEMETRY_MAX_PAYLOAD + 4];  // + CRC
+  size_t len = 0;
+  uint16_t count = 0;
+  uint16_t sequence = 0;
+  uint32_t lastUs = 0;
+  int16_t lastChannel = -1;
+  TelemetryValueCache cache;
+  size_t markLen = 0;  // State at mark(), see rollback()
+  uint16_t markCount = 0;
+  uint32_t markUs = 0;
+  int16_t markChannel = -1;
+
+  void startFrame(uint32_t timestampUs) {
+    payload[0] = TELEMETRY_VERSION;
+    payload[1] = 0;
+    payload[2] = (uint8_t)sequence;
+    payload[3] = (uint8_t)(sequence >> 8);
+    memcpy(payload + 4, &timestampUs, 4);
+    len = TELEMETRY_HEADER_SIZE;
+    lastUs = timestampUs;
+    lastChannel = -1;
+    cache.newFrame();
+  }
+
+public:
+  // Samples in the frame being built
+  uint16_t sampleCount() const {
+    return count;
+  }
+
+  // Remember the frame's end, e.g. before adding a scan
+  void mark() {
+    markLen = len;
+    markCount = count;
+    markUs = lastUs;
+    markChannel = lastChannel;
+  }
+
+  // Samples in the frame at mark()
+  uint16_t markedCount() const {
+    return markCount;
+  }
+
+  // Drop the samples added since mark(). Only finish() may follow: the
+  // value cache still holds the dropped values until the next frame.
+  void rollback() {
+    len = markLen;
+    count = markCount;
+    lastUs = markUs;
+    lastChannel = markChannel;
+  }
+
+  // Append one sample; false when the frame is full (finish() it first)
+  bool add(uint32_t timestampUs, int16_t channel, uint8_t sub, uint8_t status, float value) {
+    if (count == 0) startFrame(timestampUs);
+    if (len + TELEMETRY_MAX_SAMPLE > TELEMETRY_MAX_PAYLOAD || count == 0xFFFF) return false;
+
+    uint8_t* tag = payload + len;
+    uint8_t* p = tag + 1;
+    uint8_t flags = status & 0x07;
+
+    int16_t implied = sub ? lastChannel : lastChannel + 1;
+    if (channel != implied) {
+      flags |= TELEMETRY_TAG_CHANNEL;
+      p = telemetryPutVarint(p, telemetryZigzag((int32_t)channel - lastChannel));
+    }
+    p = telemetryPutVarint(p, timestampUs - lastUs);
+    if (sub) {
+      flags |= TELEMETRY_TAG_SUB;
+      *p++ = sub;
+    }
+
+    // Smallest lossless encoding against the last value of this key
+    uint32_t bits = telemetryFloatBits(value);
+    uint32_t prevBits = 0;
+    bool havePrev = cache.find(channel, sub, prevBits);
+    TelemetryValueKind kind = TELEMETRY_RAW;
+    uint32_t code = 0;
+    uint8_t size = 4;
+    if (havePrev && bits == prevBits) {
+      kind = TELEMETRY_SAME;
+      size = 0;
+    } else {
+      if (telemetryIsIntegral(value)) {
+        float prev = telemetryBitsFloat(prevBits);
+        int32_t base = havePrev && telemetryIsIntegral(prev) ? (int32_t)prev : 0;
+        uint32_t z = telemetryZigzag((int32_t)value - base);
+        if (telemetryVarintSize(z) < size) {
+          kind = TELEMETRY_INT;
+          code = z;
+          size = telemetryVarintSize(z);
+        }
+      }
+      if (havePrev && telemetryVarintSize(bits ^ prevBits) < size) {
+        kind = TELEMETRY_XOR;
+        code = bits ^ prevBits;
+        size = telemetryVarintSize(code);
+      }
+    }
+    flags |= kind << 3;
+    if (kind == TELEMETRY_RAW) {
+      memcpy(p, &bits, 4);
+      p += 4;
+    } else if (kind != TELEMETRY_SAME) {
+      p = telemetryPutVarint(p, code);
+    }
+
+    *tag = flags;
+    len = p - payload;
+    count++;
+    lastUs = timestampUs;
+    lastChannel = channel;
+    cache.store(channel, sub, bits);
+    return true;
+  }
+
+  // Close the frame into out (TELEMETRY_MAX_WIRE bytes): leading and
+  // trailing delimiter included. Returns the wire size, 0 if empty.
+  size_t finish(uint8_t* out) {
+    if (count == 0) return 0;
+    payload[8] = (uint8_t)count;
+    payload[9] = (uint8_t)(count >> 8);
+    uint32_t crc = logCrc32(payload, len);
+    memcpy(payload + len, &crc, 4);
+
+    out[0] = 0;
+    size_t n = 1 + cobsEncode(payload, len + 4, out + 1);
+    out[n++] = 0;
+    count = 0;
+    sequence++;
+    return n;
+  }
+};
+
+// ========== DECODER ==========
+
+struct TelemetryDecodeStats {
+  uint32_t frames;        // Good frames
+  uint32_t badFrames;     // COBS, CRC or layout errors
+  uint32_t sequenceGaps;  // Frames missing between good ones
+  uint32_t samples;
+  uint64_t bytes;         // Everything fed, delimiters included
+};
+
+typedef void (*TelemetrySampleFn)(const TelemetrySample& sample, void* context);
+
+class TelemetryDecoder {
+private:
+  uint8_t wire[TELEMETRY_MAX_WIRE];
+  size_t fill = 0;
+  bool overflow = false;  // Current frame is longer than any valid one
+  bool haveSequence = false;
+  uint16_t lastSequence = 0;
+  TelemetryDecodeStats stats = {0, 0, 0, 0, 0};
+  TelemetryValueCache cache;
+
+  // Parse a CRC-checked payload; false on a layout error
+  bool parse(const uint8_t* payload, size_t len, TelemetrySampleFn fn, void* context) {
+    const uint8_t* p = payload + TELEMETRY_HEADER_SIZE;
+    const uint8_t* end = payload + len;
+    uint32_t timeUs;
+    memcpy(&timeUs, payload + 4, 4);
+    uint16_t count = payload[8] | (payload[9] << 8);
+    int16_t channel = -1;
+    cache.newFrame();
+
+    for (uint16_t i = 0; i < count; i++) {
+      if (p >= end) return false;
+      uint8_t flags = *p++;
+      uint32_t v;
+      TelemetrySample s;
+      s.status = flags & 0x07;
+
+      int32_t next = channel;
+      if (flags & TELEMETRY_TAG_CHANNEL) {
+        if (!(p = telemetryGetVarint(p, end, v))) return false;
+        next = channel + telemetryUnzigzag(v);
+      }
+      if (!(p = telemetryGetVarint(p, end, v))) return false;
+      timeUs += v;
+      s.sub = 0;
+      if (flags & TELEMETRY_TAG_SUB) {
+        if (p >= end) return false;
+        s.sub = *p++;
+      }
+      if (!(flags & TELEMETRY_TAG_CHANNEL)) next = s.sub ? channel : channel + 1;
+      s.channel = (int16_t)next;
+      s.timestampUs = timeUs;
+
+      uint32_t prevBits = 0;
+      bool havePrev = cache.find(s.channel, s.sub, prevBits);
+      uint32_t bits;
+      switch ((flags >> 3) & 0x03) {
+        case TELEMETRY_SAME:
+          if (!havePrev) return false;
+          bits = prevBits;
+          break;
+        case TELEMETRY_INT: {
+          if (!(p = telemetryGetVarint(p, end, v))) return false;
+          float prev = telemetryBitsFloat(prevBits);
+          int32_t base = havePrev && telemetryIsIntegral(prev) ? (int32_t)prev : 0;
+          bits = telemetryFloatBits((float)(base + telemetryUnzigzag(v)));
+          break;
+        }
+        case TELEMETRY_XOR:
+          if (!havePrev || !(p = telemetryGetVarint(p, end, v))) return false;
+          bits = prevBits ^ v;
+          break;
+        default:
+          if (end - p < 4) return false;
+          memcpy(&bits, p, 4);
+          p += 4;
+          break;
+      }
+      s.value = telemetryBitsFloat(bits);
+      cache.store(s.channel, s.sub, bits);
+      channel = s.channel;
+      if (fn) fn(s, context);
+    }
+    if (p != end) return false;
+    stats.samples += count;
+    return true;
+  }
+
+  void endFrame(TelemetrySampleFn fn, void* context) {
+    if (fill == 0 && !overflow) return;  // Back-to-back delimiters
+    uint8_t payload[TELEMETRY_MAX_PAYLOAD + 4];
+    size_t len = overflow ? 0 : cobsDecode(wire, fill, payload, sizeof(payload));
+    fill = 0;
+    overflow = false;
+
+    uint32_t crc;
+    if (len < TELEMETRY_HEADER_SIZE + 4 || payload[0] != TELEMETRY_VERSION) {
+      stats.badFrames++;
+      return;
+    }
+    len -= 4;
+    memcpy(&crc, payload + len, 4);
+    if (crc != logCrc32(payload, len) || !parse(payload, len, fn, context)) {
+      stats.badFrames++;
+      return;
+    }
+
+    uint16_t sequence = payload[2] | (payload[3] << 8);
+    if (haveSequence) stats.sequenceGaps += (uint16_t)(sequence - lastSequence - 1);
+    haveSequence = true;
+    lastSequence = sequence;
+    stats.frames++;
+  }
+
+public:
+  // Feed received bytes in any chunking; fn is called for every sample
+  // of each good frame as its closing delimiter arrives
+  void feed(const uint8_t* data, size_t len, TelemetrySampleFn fn, void* context) {
+    stats.bytes += len;
+    for (size_t i = 0; i < len; i++) {
+      if (data[i] == 0) {
+        endFrame(fn, context);
+      } else if (fill < sizeof(wire)) {
+        wire[fill++] = data[i];
+      } else {
+        overflow = true;
+      }
+    }
+  }
+
+  const TelemetryDecodeStats& getStats() const {
+    return stats;
+  }
+};
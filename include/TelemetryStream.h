@@ -0,0 +1,122 @@
+/*
+ * Scan output over the serial port (USB CDC on the S3)
+ * TEXT writes one CSV line per sample, the same columns as logdump.
+ * BINARY packs whole scans into COBS frames (TelemetryFormat.h), a few
+ * bytes per sample, decoded on the host with TelemetryDecoder or
+ * tools/teledump. The mode can change at any time; switching flushes a
+ * partly packed frame first.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "ScanPlan.h"
+#include "TelemetryFormat.h"
+
+enum TelemetryMode : uint8_t {
+  TELEMETRY_OFF = 0,
+  TELEMETRY_TEXT,
+  TELEMETRY_BINARY
+};
+
+class TelemetryStream {
+private:
+  Print* out = &Serial;
+  TelemetryMode mode = TELEMETRY_OFF;
+  uint8_t scansPerFrame = 1;
+  uint8_t scansPacked = 0;
+  TelemetryEncoder encoder;
+  uint8_t wire[TELEMETRY_MAX_WIRE];
+  uint32_t frames = 0;
+  uint32_t shortWrites = 0;  // Frames the port didn't take completely
+  uint64_t bytes = 0;
+
+  size_t put(const uint8_t* data, size_t len) {
+    size_t n = out->write(data, len);
+    bytes += n;
+    if (n != len) shortWrites++;
+    return n;
+  }
+
+  void sendText(const ScanFrame& frame) {
+    char line[64];
+    for (size_t i = 0; i < frame.count; i++) {
+      int n = snprintf(line, sizeof(line), "%lu,%d,%u,%u,%.7g\n",
+                       (unsigned long)frame.timestampUs[i], frame.channel[i], frame.sub[i],
+                       frame.status[i], frame.value[i]);
+      put((const uint8_t*)line, n);
+    }
+  }
+
+  // Keep each scan in one frame: a scan that doesn't fit behind the ones
+  // already packed starts a new frame; only a scan larger than a whole
+  // frame is split
+  void sendBinary(const ScanFrame& frame) {
+    encoder.mark();
+    bool restarted = false;
+    for (size_t i = 0; i < frame.count; i++) {
+      if (encoder.add(frame.timestampUs[i], frame.channel[i], frame.sub[i], frame.status[i],
+                      frame.value[i])) {
+        continue;
+      }
+      if (!restarted && encoder.markedCount() > 0) {
+        encoder.rollback();
+        flush();
+        restarted = true;
+        i = (size_t)-1;  // Re-add the whole scan
+        continue;
+      }
+      flush();
+      encoder.add(frame.timestampUs[i], frame.channel[i], frame.sub[i], frame.status[i],
+                  frame.value[i]);
+    }
+    if (++scansPacked >= scansPerFrame) flush();
+  }
+
+public:
+  // scansPerFrame: whole scans packed per BINARY frame (1-255)
+  void setMode(TelemetryMode newMode, uint8_t packScans = 1) {
+    flush();
+    mode = newMode;
+    scansPerFrame = packScans ? packScans : 1;
+  }
+
+  void setOutput(Print* port) {
+    flush();
+    out = port;
+  }
+
+  TelemetryMode getMode() const {
+    return mode;
+  }
+
+  // Send a scan's samples in the current mode
+  void send(const ScanFrame& frame) {
+    if (mode == TELEMETRY_TEXT) {
+      sendText(frame);
+    } else if (mode == TELEMETRY_BINARY && frame.count > 0) {
+      sendBinary(frame);
+    }
+  }
+
+  // Send a partly packed frame now
+  void flush() {
+    scansPacked = 0;
+    size_t n = encoder.finish(wire);
+    if (n == 0) return;
+    put(wire, n);
+    frames++;
+  }
+
+  uint32_t frameCount() const {
+    return frames;
+  }
+
+  uint32_t shortWriteCount() const {
+    return shortWrites;
+  }
+
+  uint64_t byteCount() const {
+    return bytes;
+  }
+};
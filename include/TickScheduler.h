@@ -0,0 +1,99 @@
+/*
+ * Fixed-rate scan ticks
+ * Tick n is due at origin + n * period, so a late wake or a slow scan
+ * never shifts the ticks after it. A scan that overruns whole periods
+ * drops those ticks (counted as missed) instead of running them back to
+ * back. Records per scan: latency from the tick to the first read, and
+ * skew from the first to the last read and across the time-aligned
+ * GPIO/ADC reads. Pure arithmetic on wrapping microsecond timestamps, so
+ * it runs on the host unchanged.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "ScanPlan.h"
+
+struct TickStats {
+  uint32_t periodUs;
+  uint32_t ticks;             // Scans run
+  uint32_t missed;            // Ticks dropped because a scan ran past them
+  uint32_t lastLatencyUs;     // First read minus tick time
+  uint32_t minLatencyUs;
+  uint32_t maxLatencyUs;
+  uint64_t latencySumUs;      // For the mean: latencySumUs / ticks
+  uint32_t lastSkewUs;        // First to last read of a scan
+  uint32_t maxSkewUs;
+  uint64_t skewSumUs;
+  uint32_t lastAlignedSkewUs; // First to last GPIO/ADC read
+  uint32_t maxAlignedSkewUs;
+};
+
+class TickScheduler {
+private:
+  uint32_t periodUs = 0;
+  uint32_t nextUs = 0;
+  TickStats stats = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+public:
+  // First tick at firstUs, then every period
+  void start(uint32_t period, uint32_t firstUs) {
+    periodUs = period ? period : 1;
+    nextUs = firstUs;
+    resetStats();
+  }
+
+  uint32_t getPeriodUs() const {
+    return periodUs;
+  }
+
+  // Tick to serve at nowUs. A wake up to half a period early (timer and
+  // clock a few microseconds apart) serves the coming tick. False if no
+  // tick is due.
+  bool take(uint32_t nowUs, uint32_t& tickUs) {
+    int32_t late = (int32_t)(nowUs - nextUs);
+    if (late < -(int32_t)(periodUs / 2)) return false;
+    if (late >= (int32_t)periodUs) {
+      uint32_t skipped = (uint32_t)late / periodUs;
+      stats.missed += skipped;
+      nextUs += skipped * periodUs;
+    }
+    tickUs = nextUs;
+    nextUs += periodUs;
+    return true;
+  }
+
+  // Microseconds until the next tick, 0 if it is due
+  uint32_t untilNextUs(uint32_t nowUs) const {
+    int32_t wait = (int32_t)(nextUs - nowUs);
+    return wait > 0 ? (uint32_t)wait : 0;
+  }
+
+  // Timing of the scan run for tickUs, from the frame's read span
+  void recordScan(uint32_t tickUs, const ScanFrame& frame) {
+    int32_t latency = (int32_t)(frame.readStartUs - tickUs);
+    uint32_t l = latency > 0 ? (uint32_t)latency : 0;
+    uint32_t skew = frame.readEndUs - frame.readStartUs;
+    uint32_t aligned = frame.alignedEndUs - frame.readStartUs;
+
+    if (stats.ticks == 0 || l < stats.minLatencyUs) stats.minLatencyUs = l;
+    stats.ticks++;
+    stats.lastLatencyUs = l;
+    if (l > stats.maxLatencyUs) stats.maxLatencyUs = l;
+    stats.latencySumUs += l;
+    stats.lastSkewUs = skew;
+    if (skew > stats.maxSkewUs) stats.maxSkewUs = skew;
+    stats.skewSumUs += skew;
+    stats.lastAlignedSkewUs = aligned;
+    if (aligned > stats.maxAlignedSkewUs) stats.maxAlignedSkewUs = aligned;
+  }
+
+  const TickStats& getStats() const {
+    return stats;
+  }
+
+  void resetStats() {
+    stats = TickStats();
+    stats.periodUs = periodUs;
+  }
+};
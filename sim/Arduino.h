@@ -0,0 +1,389 @@
+/*
+ * Host Arduino core for the native build
+ * Just enough of the ESP32 Arduino API for ConfigLib and the headers in
+ * include/. Pins, buses and timing are backed by SimHardware.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include "SimHardware.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define DEC 10
+#define HEX 16
+
+#define IRAM_ATTR
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// ========== String ==========
+
+class String {
+private:
+  std::string s;
+
+public:
+  String() {}
+  String(const char* c) : s(c ? c : "") {}
+  String(const std::string& c) : s(c) {}
+  explicit String(char c) : s(1, c) {}
+  explicit String(int v) : s(std::to_string(v)) {}
+  explicit String(unsigned v) : s(std::to_string(v)) {}
+  explicit String(long v) : s(std::to_string(v)) {}
+  explicit String(unsigned long v) : s(std::to_string(v)) {}
+  explicit String(float v, unsigned decimals = 2) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    s = buf;
+  }
+
+  const char* c_str() const {
+    return s.c_str();
+  }
+
+  unsigned length() const {
+    return s.size();
+  }
+
+  bool isEmpty() const {
+    return s.empty();
+  }
+
+  bool reserve(unsigned size) {
+    s.reserve(size);
+    return true;
+  }
+
+  bool concat(const char* c) {
+    if (c) s += c;
+    return true;
+  }
+
+  bool concat(const char* c, unsigned len) {
+    if (c) s.append(c, len);
+    return true;
+  }
+
+  bool concat(char c) {
+    s += c;
+    return true;
+  }
+
+  bool concat(const String& o) {
+    s += o.s;
+    return true;
+  }
+
+  String& operator=(const char* c) {
+    s = c ? c : "";
+    return *this;
+  }
+
+  String& operator+=(const String& o) {
+    s += o.s;
+    return *this;
+  }
+
+  String& operator+=(const char* c) {
+    concat(c);
+    return *this;
+  }
+
+  String& operator+=(char c) {
+    s += c;
+    return *this;
+  }
+
+  String operator+(const String& o) const {
+    return String(s + o.s);
+  }
+
+  String operator+(const char* c) const {
+    return String(s + (c ? c : ""));
+  }
+
+  bool operator==(const String& o) const {
+    return s == o.s;
+  }
+
+  bool operator!=(const String& o) const {
+    return s != o.s;
+  }
+
+  bool operator==(const char* c) const {
+    return s == (c ? c : "");
+  }
+
+  bool operator!=(const char* c) const {
+    return !(*this == c);
+  }
+
+  bool operator<(const String& o) const {
+    return s < o.s;
+  }
+
+  char operator[](unsigned i) const {
+    return i < s.size() ? s[i] : 0;
+  }
+
+  char charAt(unsigned i) const {
+    return (*this)[i];
+  }
+
+  bool equals(const String& o) const {
+    return s == o.s;
+  }
+
+  bool equalsIgnoreCase(const String& o) const {
+    return strcasecmp(s.c_str(), o.s.c_str()) == 0;
+  }
+
+  bool startsWith(const String& o) const {
+    return s.compare(0, o.s.size(), o.s) == 0;
+  }
+
+  int indexOf(char c, unsigned from = 0) const {
+    size_t i = s.find(c, from);
+    return i == std::string::npos ? -1 : (int)i;
+  }
+
+  String substring(unsigned from, unsigned to = (unsigned)-1) const {
+    if (from >= s.size()) return String();
+    return String(s.substr(from, to > from ? to - from : 0));
+  }
+
+  void toUpperCase() {
+    for (auto& c : s) c = toupper((unsigned char)c);
+  }
+
+  void toLowerCase() {
+    for (auto& c : s) c = tolower((unsigned char)c);
+  }
+
+  void trim() {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    size_t e = s.find_last_not_of(" \t\r\n");
+    s = b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+  }
+
+  long toInt() const {
+    return strtol(s.c_str(), nullptr, 10);
+  }
+
+  float toFloat() const {
+    return strtof(s.c_str(), nullptr);
+  }
+};
+
+inline String operator+(const char* a, const String& b) {
+  return String(a) + b;
+}
+
+// Named by ArduinoJson's String adapters
+class StringSumHelper : public String {
+public:
+  StringSumHelper(const String& s) : String(s) {}
+};
+
+// ========== Print / Stream ==========
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t i = 0;
+    while (i < n && write(buf[i])) i++;
+    return i;
+  }
+
+  size_t write(const char* str) {
+    return str ? write((const uint8_t*)str, strlen(str)) : 0;
+  }
+
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n < 0) return 0;
+    if ((size_t)n < sizeof(buf)) return write((const uint8_t*)buf, n);
+    std::string big(n + 1, '\0');
+    va_start(args, fmt);
+    vsnprintf(&big[0], big.size(), fmt, args);
+    va_end(args);
+    return write((const uint8_t*)big.data(), n);
+  }
+
+  size_t print(const char* str) {
+    return write(str);
+  }
+
+  size_t print(const String& str) {
+    return write(str.c_str());
+  }
+
+  size_t print(char c) {
+    return write((uint8_t)c);
+  }
+
+  size_t print(int v, int base = DEC) {
+    return base == HEX ? printf("%X", v) : printf("%d", v);
+  }
+
+  size_t print(unsigned v, int base = DEC) {
+    return base == HEX ? printf("%X", v) : printf("%u", v);
+  }
+
+  size_t print(long v, int base = DEC) {
+    return base == HEX ? printf("%lX", v) : printf("%ld", v);
+  }
+
+  size_t print(unsigned long v, int base = DEC) {
+    return base == HEX ? printf("%lX", v) : printf("%lu", v);
+  }
+
+  size_t print(double v, int digits = 2) {
+    return printf("%.*f", digits, v);
+  }
+
+  size_t println() {
+    return write("\r\n");
+  }
+
+  template <typename T>
+  size_t println(const T& v) {
+    size_t n = print(v);
+    return n + println();
+  }
+
+  template <typename T>
+  size_t println(const T& v, int format) {
+    size_t n = print(v, format);
+    return n + println();
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  size_t readBytes(char* buf, size_t n) {
+    size_t i = 0;
+    for (int c; i < n && (c = read()) >= 0; i++) buf[i] = (char)c;
+    return i;
+  }
+
+  size_t readBytes(uint8_t* buf, size_t n) {
+    return readBytes((char*)buf, n);
+  }
+};
+
+// Serial writes to stdout; setOutput(nullptr) mutes it (e.g. for benchmarks)
+class HardwareSerial : public Stream {
+private:
+  FILE* out = stdout;
+
+public:
+  void begin(unsigned long baud) {
+    (void)baud;
+  }
+
+  void setOutput(FILE* f) {
+    out = f;
+  }
+
+  size_t write(uint8_t c) override {
+    return out ? fwrite(&c, 1, 1, out) : 1;
+  }
+
+  size_t write(const uint8_t* buf, size_t n) override {
+    return out ? fwrite(buf, 1, n, out) : n;
+  }
+
+  using Print::write;
+
+  int available() override {
+    return 0;
+  }
+
+  int read() override {
+    return -1;
+  }
+
+  int peek() override {
+    return -1;
+  }
+
+  void flush() {
+    if (out) fflush(out);
+  }
+
+  operator bool() const {
+    return true;
+  }
+};
+
+extern HardwareSerial Serial;
+
+// ========== Core functions ==========
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+  Sim.pinMode(pin, mode);
+}
+
+inline int digitalRead(uint8_t pin) {
+  return Sim.digitalRead(pin);
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t val) {
+  Sim.digitalWrite(pin, val);
+}
+
+inline uint16_t analogRead(uint8_t pin) {
+  return Sim.analogRead(pin);
+}
+
+inline void attachInterruptArg(uint8_t pin, void (*fn)(void*), void* arg, int mode) {
+  Sim.attachInterrupt(pin, fn, arg, mode);
+}
+
+inline void detachInterrupt(uint8_t pin) {
+  Sim.detachInterrupt(pin);
+}
+
+inline uint8_t digitalPinToInterrupt(uint8_t pin) {
+  return pin;
+}
@@ -0,0 +1,117 @@
+/*
+ * Host OneWire backed by SimHardware's DS18B20 list for the pin
+ * Understands Skip/Match ROM, Convert T, Read and Write Scratchpad.
+ * search() walks the devices in insertion order.
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+class OneWire {
+private:
+  int pin = -1;
+  int selected = -1;        // Device index, -2 = all (Skip ROM), -1 = none
+  uint8_t command = 0;      // Function command in progress
+  uint8_t writeIndex = 0;   // Bytes written after Write Scratchpad
+  uint8_t readBuf[9];
+  uint8_t readPos = 9;
+  size_t searchIndex = 0;
+
+  std::vector<SimDS18B20>& devices() {
+    return Sim.oneWireDevices(pin);
+  }
+
+  void functionCommand(uint8_t cmd);
+  void dataByte(uint8_t v);
+
+public:
+  OneWire() {}
+
+  explicit OneWire(uint8_t p) {
+    begin(p);
+  }
+
+  void begin(uint8_t p) {
+    pin = p;
+    selected = -1;
+  }
+
+  // 1 if any device answered with a presence pulse
+  uint8_t reset() {
+    Sim.chargeOneWireReset();
+    selected = -1;
+    command = 0;
+    readPos = sizeof(readBuf);
+    return devices().empty() ? 0 : 1;
+  }
+
+  void skip() {
+    Sim.chargeOneWireBytes(1);
+    selected = -2;
+  }
+
+  void select(const uint8_t rom[8]) {
+    Sim.chargeOneWireBytes(9);
+    selected = -1;
+    for (size_t i = 0; i < devices().size(); i++) {
+      if (memcmp(devices()[i].rom, rom, 8) == 0) selected = (int)i;
+    }
+  }
+
+  void write(uint8_t v, uint8_t power = 0) {
+    (void)power;
+    Sim.chargeOneWireBytes(1);
+    if (command == 0) {
+      functionCommand(v);
+    } else {
+      dataByte(v);
+    }
+  }
+
+  void write_bytes(const uint8_t* buf, uint16_t n, bool power = 0) {
+    for (uint16_t i = 0; i < n; i++) write(buf[i], power);
+  }
+
+  uint8_t read() {
+    Sim.chargeOneWireBytes(1);
+    return readPos < sizeof(readBuf) ? readBuf[readPos++] : 0xFF;
+  }
+
+  void read_bytes(uint8_t* buf, uint16_t n) {
+    for (uint16_t i = 0; i < n; i++) buf[i] = read();
+  }
+
+  uint8_t read_bit() {
+    return 1;
+  }
+
+  void depower() {}
+
+  void reset_search() {
+    searchIndex = 0;
+  }
+
+  bool search(uint8_t* newAddr, bool searchMode = true) {
+    (void)searchMode;
+    Sim.chargeOneWireReset();
+    Sim.chargeOneWireBytes(25);  // Command plus 64 triplets of 3 slots
+    if (searchIndex >= devices().size()) return false;
+    memcpy(newAddr, devices()[searchIndex++].rom, 8);
+    return true;
+  }
+
+  static uint8_t crc8(const uint8_t* addr, uint8_t len) {
+    uint8_t crc = 0;
+    while (len--) {
+      uint8_t in = *addr++;
+      for (uint8_t i = 8; i; i--) {
+        uint8_t mix = (crc ^ in) & 0x01;
+        crc >>= 1;
+        if (mix) crc ^= 0x8C;
+        in >>= 1;
+      }
+    }
+    return crc;
+  }
+};
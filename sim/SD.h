@@ -0,0 +1,130 @@
+/*
+ * Host SD card stored under SimHardware's SD root directory
+ * Paths are card-absolute ("/config.json") and map to <root>/config.json.
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+class File : public Stream {
+private:
+  FILE* f = nullptr;
+  std::string path;
+
+public:
+  File() {}
+  File(FILE* fp, const std::string& name) : f(fp), path(name) {}
+
+  operator bool() const {
+    return f != nullptr;
+  }
+
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+
+  size_t write(const uint8_t* buf, size_t n) override {
+    if (!f) return 0;
+    Sim.chargeSdBytes(n);
+    return fwrite(buf, 1, n, f);
+  }
+
+  using Print::write;
+
+  int read() override {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+
+  size_t read(uint8_t* buf, size_t n) {
+    if (!f) return 0;
+    size_t got = fread(buf, 1, n, f);
+    Sim.chargeSdBytes(got);
+    return got;
+  }
+
+  int peek() override {
+    if (!f) return -1;
+    int c = fgetc(f);
+    if (c >= 0) ungetc(c, f);
+    return c;
+  }
+
+  int available() override {
+    return f ? (int)(size() - position()) : 0;
+  }
+
+  size_t size() {
+    if (!f) return 0;
+    long pos = ftell(f);
+    fseek(f, 0, SEEK_END);
+    long end = ftell(f);
+    fseek(f, pos, SEEK_SET);
+    return end;
+  }
+
+  size_t position() {
+    return f ? ftell(f) : 0;
+  }
+
+  bool seek(uint32_t pos) {
+    return f && fseek(f, pos, SEEK_SET) == 0;
+  }
+
+  void flush() {
+    if (f) fflush(f);
+  }
+
+  void close() {
+    if (f) fclose(f);
+    f = nullptr;
+  }
+
+  const char* name() const {
+    return path.c_str();
+  }
+
+  bool isDirectory() {
+    return false;
+  }
+};
+
+class SDClass {
+private:
+  std::string hostPath(const char* path) const {
+    return Sim.getSdRoot() + path;
+  }
+
+public:
+  bool begin(uint8_t csPin = 0);
+  bool mkdir(const char* path);
+  bool exists(const char* path);
+
+  File open(const char* path, const char* mode = FILE_READ) {
+    Sim.chargeSdOp();
+    const char* hostMode = strcmp(mode, FILE_WRITE) == 0 ? "wb" :
+                           strcmp(mode, FILE_APPEND) == 0 ? "ab" : "rb";
+    return File(fopen(hostPath(path).c_str(), hostMode), path);
+  }
+
+  File open(const String& path, const char* mode = FILE_READ) {
+    return open(path.c_str(), mode);
+  }
+
+  bool remove(const char* path) {
+    Sim.chargeSdOp();
+    return ::remove(hostPath(path).c_str()) == 0;
+  }
+
+  bool rename(const char* from, const char* to) {
+    Sim.chargeSdOp();
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+  }
+};
+
+extern SDClass SD;
@@ -0,0 +1,72 @@
+/*
+ * Host SPIClass; the selected device is whichever simulated SPI device
+ * has its CS pin driven low
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x01
+#define SPI_MODE2 0x02
+#define SPI_MODE3 0x03
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+class SPISettings {
+public:
+  uint32_t clock;
+  uint8_t bitOrder;
+  uint8_t dataMode;
+
+  SPISettings() : clock(1000000), bitOrder(MSBFIRST), dataMode(SPI_MODE0) {}
+  SPISettings(uint32_t clockHz, uint8_t order, uint8_t mode)
+      : clock(clockHz), bitOrder(order), dataMode(mode) {}
+};
+
+class SPIClass {
+private:
+  SPISettings settings;
+
+public:
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+    (void)sck;
+    (void)miso;
+    (void)mosi;
+    (void)ss;
+  }
+
+  void end() {}
+
+  void beginTransaction(SPISettings s) {
+    settings = s;
+    Sim.chargeSpiTransaction();
+  }
+
+  void endTransaction() {}
+
+  uint8_t transfer(uint8_t data) {
+    return Sim.spiTransfer(data);
+  }
+
+  uint16_t transfer16(uint16_t data) {
+    uint16_t hi = transfer(data >> 8);
+    return (hi << 8) | transfer(data & 0xFF);
+  }
+
+  void transfer(void* buf, size_t n) {
+    uint8_t* p = (uint8_t*)buf;
+    for (size_t i = 0; i < n; i++) p[i] = transfer(p[i]);
+  }
+
+  void transferBytes(const uint8_t* out, uint8_t* in, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+      uint8_t b = transfer(out ? out[i] : 0xFF);
+      if (in) in[i] = b;
+    }
+  }
+};
+
+extern SPIClass SPI;
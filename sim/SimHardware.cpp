@@ -0,0 +1,213 @@
+/*
+ * SimHardware and host Arduino globals
+ */
+
+#include <chrono>
+#include <thread>
+#include <sys/stat.h>
+#include "Arduino.h"
+#include "OneWire.h"
+#include "SD.h"
+#include "SPI.h"
+#include "Wire.h"
+
+SimHardware Sim;
+HardwareSerial Serial;
+TwoWire Wire;
+SPIClass SPI;
+SDClass SD;
+
+static const auto bootTime = std::chrono::steady_clock::now();
+
+// ========== Core functions ==========
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+  Sim.spend(us * 1000);
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+// ========== SimHardware ==========
+
+// Busy-wait, like the real bus: sleeping would let the host scheduler
+// stretch short waits by tens of microseconds
+void SimHardware::spend(uint32_t ns) {
+  if (ns == 0) return;
+  auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(ns);
+  while (std::chrono::steady_clock::now() < until) {
+  }
+}
+
+void SimHardware::reset() {
+  counters = SimCounters();
+  memset(pinModes, 0, sizeof(pinModes));
+  memset(levels, 0, sizeof(levels));
+  memset(analogValues, 0, sizeof(analogValues));
+  for (int i = 0; i < SIM_MAX_PINS; i++) {
+    isr[i] = nullptr;
+    oneWire[i].clear();
+  }
+  memset(i2c, 0, sizeof(i2c));
+  spiDevices.clear();
+}
+
+void SimHardware::setDigital(int pin, int level) {
+  if (!validPin(pin)) return;
+  uint8_t old = levels[pin];
+  levels[pin] = level ? 1 : 0;
+  if (!isr[pin] || old == levels[pin]) return;
+  bool rising = levels[pin] > old;
+  if (isrMode[pin] == CHANGE || (isrMode[pin] == RISING && rising) ||
+      (isrMode[pin] == FALLING && !rising)) {
+    isr[pin](isrArg[pin]);
+  }
+}
+
+void SimHardware::addSpiDevice(int csPin, const uint8_t* response, size_t len) {
+  SimSpiDevice d;
+  d.csPin = csPin;
+  d.response.assign(response, response + len);
+  d.next = 0;
+  spiDevices.push_back(d);
+  if (validPin(csPin)) levels[csPin] = 1;  // Idle high
+}
+
+uint8_t SimHardware::spiTransfer(uint8_t out) {
+  (void)out;
+  counters.spiBytes++;
+  spend(latency.spiByteNs);
+  SimSpiDevice* d = selectedSpi();
+  if (!d || d->response.empty()) return 0xFF;  // Nothing drives MISO
+  uint8_t v = d->response[d->next];
+  d->next = (d->next + 1) % d->response.size();
+  return v;
+}
+
+void SimHardware::setI2CRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t len) {
+  SimI2CDevice& d = i2c[address & 0x7F];
+  for (size_t i = 0; i < len; i++) d.regs[(uint8_t)(reg + i)] = data[i];
+}
+
+// 9 clocks per byte (8 data + ACK)
+static uint32_t i2cByteTime(const SimLatency& l, uint32_t clockHz) {
+  return l.i2cFromClock ? (uint32_t)(9000000000ULL / clockHz) : l.i2cByteNs;
+}
+
+bool SimHardware::i2cWrite(uint8_t address, const uint8_t* data, size_t len) {
+  SimI2CDevice& d = i2c[address & 0x7F];
+  bool present = __atomic_load_n(&d.present, __ATOMIC_RELAXED);
+  counters.i2cTransactions++;
+  size_t bytes = present ? 1 + len : 1;  // A NACKed address ends the transfer
+  counters.i2cBytes += bytes;
+  spend(latency.i2cOverheadNs + i2cByteTime(latency, i2cClockHz) * bytes);
+  if (!present) return false;
+  if (len > 0) d.pointer = data[0];
+  for (size_t i = 1; i < len; i++) d.regs[d.pointer++] = data[i];
+  return true;
+}
+
+bool SimHardware::i2cRead(uint8_t address, uint8_t* data, size_t len) {
+  SimI2CDevice& d = i2c[address & 0x7F];
+  bool present = __atomic_load_n(&d.present, __ATOMIC_RELAXED);
+  counters.i2cTransactions++;
+  size_t bytes = present ? 1 + len : 1;
+  counters.i2cBytes += bytes;
+  spend(latency.i2cOverheadNs + i2cByteTime(latency, i2cClockHz) * bytes);
+  if (!present) return false;
+  for (size_t i = 0; i < len; i++) data[i] = d.regs[d.pointer++];
+  return true;
+}
+
+void SimHardware::addDS18B20(int pin, float temperature) {
+  if (!validPin(pin) || oneWire[pin].size() >= SIM_MAX_ONEWIRE_DEVICES) return;
+  SimDS18B20 d;
+  d.rom[0] = 0x28;
+  d.rom[1] = (uint8_t)pin;
+  d.rom[2] = (uint8_t)oneWire[pin].size();
+  for (int i = 3; i < 7; i++) d.rom[i] = 0x5A ^ (uint8_t)(i * 17 + pin);
+  d.rom[7] = OneWire::crc8(d.rom, 7);
+  d.temperature = temperature;
+  // Power-on scratchpad: 85 C, 12-bit config
+  const uint8_t por[8] = {0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10};
+  memcpy(d.scratchpad, por, 8);
+  d.scratchpad[8] = OneWire::crc8(d.scratchpad, 8);
+  oneWire[pin].push_back(d);
+}
+
+void SimHardware::setDS18B20Temperature(int pin, size_t index, float temperature) {
+  if (validPin(pin) && index < oneWire[pin].size()) oneWire[pin][index].temperature = temperature;
+}
+
+// ========== OneWire ==========
+
+void OneWire::functionCommand(uint8_t cmd) {
+  command = cmd;
+  writeIndex = 0;
+  std::vector<SimDS18B20>& devs = devices();
+
+  if (cmd == 0x44) {  // Convert T: latch the temperature at the set resolution
+    for (size_t i = 0; i < devs.size(); i++) {
+      if (selected != -2 && selected != (int)i) continue;
+      SimDS18B20& d = devs[i];
+      int bits = 9 + ((d.scratchpad[4] >> 5) & 0x03);
+      int16_t raw = (int16_t)lroundf(d.temperature * 16.0f);
+      raw &= ~((1 << (12 - bits)) - 1);
+      d.scratchpad[0] = raw & 0xFF;
+      d.scratchpad[1] = (raw >> 8) & 0xFF;
+      d.scratchpad[8] = crc8(d.scratchpad, 8);
+    }
+  } else if (cmd == 0xBE && selected >= 0) {  // Read Scratchpad needs one device
+    memcpy(readBuf, devs[selected].scratchpad, sizeof(readBuf));
+    readPos = 0;
+  }
+}
+
+void OneWire::dataByte(uint8_t v) {
+  if (command != 0x4E || writeIndex >= 3) return;  // Write Scratchpad: TH, TL, config
+  std::vector<SimDS18B20>& devs = devices();
+  for (size_t i = 0; i < devs.size(); i++) {
+    if (selected != -2 && selected != (int)i) continue;
+    devs[i].scratchpad[2 + writeIndex] = v;
+    devs[i].scratchpad[8] = crc8(devs[i].scratchpad, 8);
+  }
+  writeIndex++;
+}
+
+// ========== SD ==========
+
+static bool makeDir(const std::string& path) {
+  return ::mkdir(path.c_str(), 0755) == 0;
+}
+
+bool SDClass::begin(uint8_t csPin) {
+  (void)csPin;
+  struct stat st;
+  return stat(Sim.getSdRoot().c_str(), &st) == 0 || makeDir(Sim.getSdRoot());
+}
+
+bool SDClass::mkdir(const char* path) {
+  Sim.chargeSdOp();
+  return makeDir(hostPath(path));
+}
+
+bool SDClass::exists(const char* path) {
+  Sim.chargeSdOp();
+  struct stat st;
+  return stat(hostPath(path).c_str(), &st) == 0;
+}
@@ -0,0 +1,258 @@
+/*
+ * Simulated board for the native build
+ * Backs the host Arduino headers in this directory: GPIO levels, ADC
+ * values, SPI responses, I2C register maps, DS18B20s on OneWire pins and
+ * an SD card stored in a host directory. Every bus operation costs a
+ * configurable latency (busy-wait), so host timings include modeled bus
+ * time, and is counted so benchmarks can report operations per scan.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#define SIM_MAX_PINS 64
+#define SIM_MAX_ONEWIRE_DEVICES 16
+
+// Cost of each operation in nanoseconds, 0 = free
+struct SimLatency {
+  uint32_t digitalNs;     // digitalRead / digitalWrite
+  uint32_t analogNs;      // analogRead
+  uint32_t spiByteNs;     // One byte clocked on SPI
+  uint32_t i2cByteNs;     // One byte incl. ACK on I2C
+  bool i2cFromClock;      // Derive i2cByteNs from the Wire clock instead
+  uint32_t i2cOverheadNs; // Start/stop per transaction
+  uint32_t oneWireResetNs;
+  uint32_t oneWireByteNs;
+  uint32_t sdOpenNs;      // open / exists / remove / rename
+  uint32_t sdBlockNs;     // Per 512 bytes read or written
+
+  // Code cost only
+  static SimLatency none() {
+    SimLatency l = {0, 0, 0, 0, false, 0, 0, 0, 0, 0};
+    return l;
+  }
+
+  // Roughly an ESP32-S3 with SPI at 4 MHz and a SPI-mode SD card
+  static SimLatency typical() {
+    SimLatency l = {100, 20000, 2000, 0, true, 10000, 960000, 560000, 2000000, 250000};
+    return l;
+  }
+};
+
+// Operation counters, reset with SimHardware::resetCounters()
+struct SimCounters {
+  uint32_t digitalOps;
+  uint32_t analogReads;
+  uint32_t spiBytes;
+  uint32_t spiTransactions;  // beginTransaction() calls
+  uint32_t i2cTransactions;
+  uint32_t i2cBytes;
+  uint32_t oneWireResets;
+  uint32_t oneWireBytes;
+  uint32_t sdOps;
+  uint32_t sdBytes;
+};
+
+struct SimI2CDevice {
+  bool present;
+  uint8_t pointer;         // Register pointer, auto-increments
+  uint8_t regs[256];
+};
+
+struct SimDS18B20 {
+  uint8_t rom[8];
+  float temperature;       // Reported on the next Convert T
+  uint8_t scratchpad[9];
+};
+
+struct SimSpiDevice {
+  int csPin;
+  std::vector<uint8_t> response;  // Returned cyclically while selected
+  size_t next;
+};
+
+class SimHardware {
+private:
+  SimLatency latency = SimLatency::none();
+  SimCounters counters = {};
+  uint32_t i2cClockHz = 100000;
+
+  uint8_t pinModes[SIM_MAX_PINS] = {};
+  uint8_t levels[SIM_MAX_PINS] = {};
+  uint16_t analogValues[SIM_MAX_PINS] = {};
+  void (*isr[SIM_MAX_PINS])(void*) = {};
+  void* isrArg[SIM_MAX_PINS] = {};
+  int isrMode[SIM_MAX_PINS] = {};
+
+  SimI2CDevice i2c[128] = {};
+  std::vector<SimSpiDevice> spiDevices;
+  std::vector<SimDS18B20> oneWire[SIM_MAX_PINS];
+  std::string sdRoot = "sim_sd";
+
+  static bool validPin(int pin) {
+    return pin >= 0 && pin < SIM_MAX_PINS;
+  }
+
+  SimSpiDevice* selectedSpi() {
+    for (auto& d : spiDevices) {
+      if (validPin(d.csPin) && levels[d.csPin] == 0) return &d;
+    }
+    return nullptr;
+  }
+
+public:
+  // Spin for ns nanoseconds of simulated bus time
+  void spend(uint32_t ns);
+
+  void setLatency(const SimLatency& l) {
+    latency = l;
+  }
+
+  const SimLatency& getLatency() const {
+    return latency;
+  }
+
+  const SimCounters& getCounters() const {
+    return counters;
+  }
+
+  void resetCounters() {
+    counters = SimCounters();
+  }
+
+  // Forget all devices and pin state; latency and SD root are kept
+  void reset();
+
+  // ========== GPIO / ADC ==========
+
+  void setDigital(int pin, int level);
+  void setAnalog(int pin, uint16_t raw) {
+    if (validPin(pin)) analogValues[pin] = raw;
+  }
+
+  // Current pin value without a conversion's cost (continuous ADC source)
+  uint16_t analogValue(int pin) const {
+    return validPin(pin) ? analogValues[pin] : 0;
+  }
+
+  void pinMode(int pin, uint8_t mode) {
+    if (validPin(pin)) pinModes[pin] = mode;
+  }
+
+  int digitalRead(int pin) {
+    counters.digitalOps++;
+    spend(latency.digitalNs);
+    return validPin(pin) ? levels[pin] : 0;
+  }
+
+  void digitalWrite(int pin, int level) {
+    counters.digitalOps++;
+    spend(latency.digitalNs);
+    if (validPin(pin)) levels[pin] = level ? 1 : 0;
+  }
+
+  // One GPIO input register: levels of pins bank*32 .. bank*32+31
+  uint32_t readGpioBank(int bank) {
+    counters.digitalOps++;
+    spend(latency.digitalNs);
+    uint32_t bits = 0;
+    for (int i = 0; i < 32; i++) {
+      int pin = bank * 32 + i;
+      if (validPin(pin) && levels[pin]) bits |= 1UL << i;
+    }
+    return bits;
+  }
+
+  uint16_t analogRead(int pin) {
+    counters.analogReads++;
+    spend(latency.analogNs);
+    return validPin(pin) ? analogValues[pin] : 0;
+  }
+
+  void attachInterrupt(int pin, void (*fn)(void*), void* arg, int mode) {
+    if (!validPin(pin)) return;
+    isr[pin] = fn;
+    isrArg[pin] = arg;
+    isrMode[pin] = mode;
+  }
+
+  void detachInterrupt(int pin) {
+    if (validPin(pin)) isr[pin] = nullptr;
+  }
+
+  // ========== SPI ==========
+
+  // Device whose CS is pin; returns response bytes while CS is low
+  void addSpiDevice(int csPin, const uint8_t* response, size_t len);
+  uint8_t spiTransfer(uint8_t out);
+
+  void chargeSpiTransaction() {
+    counters.spiTransactions++;
+  }
+
+  // ========== I2C ==========
+
+  void setI2CClock(uint32_t hz) {
+    i2cClockHz = hz ? hz : 100000;
+  }
+
+  // Plugging and unplugging may happen while another thread is scanning
+  void addI2CDevice(uint8_t address) {
+    __atomic_store_n(&i2c[address & 0x7F].present, true, __ATOMIC_RELAXED);
+  }
+
+  void removeI2CDevice(uint8_t address) {
+    __atomic_store_n(&i2c[address & 0x7F].present, false, __ATOMIC_RELAXED);
+  }
+
+  void setI2CRegisters(uint8_t address, uint8_t reg, const uint8_t* data, size_t len);
+
+  // One transaction: address byte plus len data bytes. Returns false on NACK.
+  bool i2cWrite(uint8_t address, const uint8_t* data, size_t len);
+  bool i2cRead(uint8_t address, uint8_t* data, size_t len);
+
+  // ========== OneWire ==========
+
+  // Adds a DS18B20 (family 0x28) with a generated ROM on pin
+  void addDS18B20(int pin, float temperature);
+  void setDS18B20Temperature(int pin, size_t index, float temperature);
+  std::vector<SimDS18B20>& oneWireDevices(int pin) {
+    return oneWire[validPin(pin) ? pin : 0];
+  }
+
+  void chargeOneWireReset() {
+    counters.oneWireResets++;
+    spend(latency.oneWireResetNs);
+  }
+
+  void chargeOneWireBytes(size_t n) {
+    counters.oneWireBytes += n;
+    spend(latency.oneWireByteNs * n);
+  }
+
+  // ========== SD ==========
+
+  void setSdRoot(const std::string& path) {
+    sdRoot = path;
+  }
+
+  const std::string& getSdRoot() const {
+    return sdRoot;
+  }
+
+  void chargeSdOp() {
+    counters.sdOps++;
+    spend(latency.sdOpenNs);
+  }
+
+  void chargeSdBytes(size_t n) {
+    counters.sdBytes += n;
+    spend((uint32_t)((uint64_t)latency.sdBlockNs * n / 512));
+  }
+};
+
+extern SimHardware Sim;
@@ -0,0 +1,99 @@
+/*
+ * Host TwoWire backed by SimHardware's I2C register maps
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+#define I2C_BUFFER_LENGTH 128
+
+class TwoWire : public Stream {
+private:
+  uint8_t txAddress = 0;
+  uint8_t txBuf[I2C_BUFFER_LENGTH];
+  size_t txLen = 0;
+  uint8_t rxBuf[I2C_BUFFER_LENGTH];
+  size_t rxLen = 0;
+  size_t rxPos = 0;
+  uint32_t clockHz = 100000;
+  uint16_t timeoutMs = 50;
+
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+    (void)sda;
+    (void)scl;
+    if (frequency) setClock(frequency);
+    return true;
+  }
+
+  bool end() {
+    return true;
+  }
+
+  void setClock(uint32_t hz) {
+    clockHz = hz;
+    Sim.setI2CClock(hz);
+  }
+
+  uint32_t getClock() {
+    return clockHz;
+  }
+
+  void setTimeOut(uint16_t ms) {
+    timeoutMs = ms;
+  }
+
+  uint16_t getTimeOut() {
+    return timeoutMs;
+  }
+
+  void beginTransmission(uint8_t address) {
+    txAddress = address;
+    txLen = 0;
+  }
+
+  // 0 = ok, 2 = address NACK (same codes as the ESP32 core)
+  uint8_t endTransmission(bool sendStop = true) {
+    (void)sendStop;
+    return Sim.i2cWrite(txAddress, txBuf, txLen) ? 0 : 2;
+  }
+
+  size_t requestFrom(uint8_t address, size_t len, bool sendStop = true) {
+    (void)sendStop;
+    rxPos = 0;
+    rxLen = 0;
+    if (len > sizeof(rxBuf)) len = sizeof(rxBuf);
+    if (!Sim.i2cRead(address, rxBuf, len)) return 0;
+    rxLen = len;
+    return len;
+  }
+
+  size_t write(uint8_t c) override {
+    if (txLen >= sizeof(txBuf)) return 0;
+    txBuf[txLen++] = c;
+    return 1;
+  }
+
+  size_t write(const uint8_t* buf, size_t n) override {
+    size_t i = 0;
+    while (i < n && write(buf[i])) i++;
+    return i;
+  }
+
+  using Print::write;
+
+  int available() override {
+    return (int)(rxLen - rxPos);
+  }
+
+  int read() override {
+    return rxPos < rxLen ? rxBuf[rxPos++] : -1;
+  }
+
+  int peek() override {
+    return rxPos < rxLen ? rxBuf[rxPos] : -1;
+  }
+};
+
+extern TwoWire Wire;
@@ -10,6 +10,27 @@
 #include <Wire.h>
 #include <OneWire.h>
 #include <vector>
+#include <algorithm>
+#include "ChannelTable.h"
+#include "ScanPlan.h"
+#include "Acquisition.h"
+#include "DS18B20Bus.h"
+#include "I2CEngine.h"
+#include "I2CDiscovery.h"
+#include "I2CDrivers.h"
+#include "DeadlineScheduler.h"
+#include "AdcStream.h"
+#include "EdgeCounter.h"
+#include "GpioSnapshot.h"
+#include "SpiEngine.h"
+#include "ReadStats.h"
+#include "ChannelStats.h"
+#include "SampleLogger.h"
+#include "TelemetryStream.h"
+#include "HistoryStore.h"
+#include "ConfigSnapshot.h"
+#include "BoardProfile.h"
+#include "Log.h"
 
 // SD Card SPI pins for ESP32-S3
 #define SD_CS 10
@@ -24,14 +45,39 @@
 // Channel configuration
 #define MAX_FIXED_CHANNELS 30  // Change this to set how many fixed channels you have
 // I2C channels will start after this number
+#define DEFAULT_PERIOD_MS 1000  // scanDue() period for channels without their own rate
+#define I2C_DISCOVERY_INTERVAL_US 100000  // Background discovery step interval in scanDue()
+#define ADC_DEFAULT_OVERSAMPLE 16  // Continuous ADC conversions averaged per value
+
+// -DBOARD_PROFILE=DevKitProfile (or a profile of your own, see BoardProfile.h)
+// compiles the fixed channels in; JSON then only configures I2C channels and
+// the rate, filter and active settings of the fixed ones
+#if defined(BOARD_PROFILE)
+typedef BOARD_PROFILE FixedProfile;
+static_assert(FixedProfile::maxChannel() <= MAX_FIXED_CHANNELS,
+              "board profile channels must be <= MAX_FIXED_CHANNELS");
+#endif
 
 const char* CONFIG_FILE = "/config.json";
+const char* CONFIG_TEMP_FILE = "/config.tmp";    // New config is written here first
+const char* CONFIG_BACKUP_FILE = "/config.bak";  // Previous good config
+const char* SNAPSHOT_FILE = "/config.bin";       // Binary copy of the channel tables
+
+EventLog eventLog;  // Deferred hot-path log, see Log.h
+SpiBusArbiter spiBus;  // SPI sensors and the SD card share one bus
 
 struct FixedChannel {
   int channel;
   int pin;
-  String mode;  // "DIGITAL", "ANALOG", "ONEWIRE", "SPI"
+  String mode;  // "DIGITAL", "ANALOG", "ONEWIRE", "SPI", "COUNTER", "FREQUENCY", "DUTY"
   bool active;
+  int sensor;   // ONEWIRE: which sensor on this pin (0 = first found)
+  uint32_t periodUs;  // Sampling period for scanDue(), 0 = default period
+  uint32_t spiClockHz;  // SPI: bus clock, 0 = SPI_DEFAULT_CLOCK
+  uint8_t spiMode;      // SPI: 0-3
+  uint8_t spiCommand;   // SPI: byte sent before the response, 0 = none
+  uint8_t spiLength;    // SPI: response bytes (1-4, big-endian), 0 = 1
+  FilterSettings filter;  // Output stage for filterScan(), zero = off
 };
 
 struct I2CChannel {
@@ -39,46 +85,412 @@ struct I2CChannel {
   int id;
   uint8_t address;
   bool active;
+  int reg;         // Register to read from, -1 = read without a register write
+  uint8_t length;  // Bytes to read (1-4, big-endian), 0 = 2
+  bool missing;    // Deactivated by discovery, reactivated when it answers again
+  uint32_t periodUs;  // Sampling period for scanDue(), 0 = default period
+  String driver;      // Decoder from I2CDrivers.h, "" = raw value from reg/length
+  FilterSettings filter;  // Output stage for filterScan(), applies to every value
 };
 
 class ConfigManager {
 private:
   std::vector<FixedChannel> fixedChannels;
   std::vector<I2CChannel> i2cChannels;
+  ChannelTable channelTable;
+  ScanPlan scanPlan;
+  DS18B20Bus oneWireBuses[MAX_ONEWIRE_BUSES];
+  uint8_t oneWireResolution = 12;
+  EdgeCounter edgeCounters[MAX_EDGE_COUNTERS];
+  I2CEngine i2cEngine;
+  std::vector<I2CDevice> i2cDevices;  // Parallel to i2cChannels, drivers resolved
+  size_t scanValues = 0;  // Frame entries one scanAll() produces
+  uint32_t truncatedValues = 0;  // Entries scanAll() dropped because the frame was too small
+  std::vector<ChannelFilter> filters;  // One per scan value with settings
+  std::vector<int16_t> filterBase;     // By channel number: first filter, -1 = none
+  SpiEngine spiEngine;
+  I2CDiscovery i2cDiscovery;
+  uint8_t discoveryPerScan = 0;  // Addresses probed per scanAll(), 0 = off
+  uint32_t nextDiscoveryUs = 0;  // scanDue() probes at most every I2C_DISCOVERY_INTERVAL_US
+  DeadlineScheduler scheduler;
+  std::vector<uint16_t> dueList;  // Scratch for scanDue(), sized with the plan
+  mutable ScanMutex scanMutex;    // Scans vs. table rebuilds from the other core
+  ReadStatsCollector readStats;   // Timing and status counts of every read
+  uint32_t defaultPeriodUs = DEFAULT_PERIOD_MS * 1000UL;
+  AdcStream adcStream;
+  uint32_t adcStreamHz = 0;  // Continuous ADC conversions per pin per second, 0 = off
+  uint16_t adcOversample = ADC_DEFAULT_OVERSAMPLE;
+  uint8_t adcSmoothing = 0;
+  int batchDepth = 0;  // Nested beginBatch() calls still open
+  bool dirty = false;  // Channels changed since the last successful save
+  BootStats bootStats = {false, 0, 0, 0};
+#if defined(BOARD_PROFILE)
+  bool profileEnabled = true;
+  bool profileActive = false;  // Plan matches FixedProfile, scanAll() uses its scan
+#endif
+
+  // CRC32 of a file's bytes, streamed in small chunks
+  static uint32_t hashFile(File& file) {
+    uint8_t buf[256];
+    uint32_t crc = 0;
+    int n;
+    while ((n = file.read(buf, sizeof(buf))) > 0) {
+      crc = logCrc32(buf, n, crc);
+    }
+    return crc;
+  }
+
+  // "sample_rate_hz" or "period_ms" to a period in us, 0 if neither is set
+  static uint32_t periodFromJson(JsonObject ch) {
+    float hz = ch["sample_rate_hz"] | 0.0f;
+    if (hz > 0) return (uint32_t)(1000000.0f / hz + 0.5f);
+    float ms = ch["period_ms"] | 0.0f;
+    return ms > 0 ? (uint32_t)(ms * 1000.0f + 0.5f) : 0;
+  }
+
+  // Whole milliseconds save as "period_ms", anything finer as "sample_rate_hz"
+  static void periodToJson(JsonObject obj, uint32_t periodUs) {
+    if (periodUs == 0) return;
+    if (periodUs % 1000 == 0) {
+      obj["period_ms"] = periodUs / 1000;
+    } else {
+      obj["sample_rate_hz"] = 1000000.0f / periodUs;
+    }
+  }
+
+  // "decimate", "deadband", "stats_window", "report_interval_ms"
+  static FilterSettings filterFromJson(JsonObject ch) {
+    FilterSettings f;
+    f.decimate = ch["decimate"] | 0;
+    f.statsWindow = ch["stats_window"] | 0;
+    f.deadband = ch["deadband"] | 0.0f;
+    f.reportIntervalMs = std::min<uint32_t>(ch["report_interval_ms"] | 0, MAX_REPORT_INTERVAL_MS);
+    return f;
+  }
+
+  static void filterToJson(JsonObject obj, const FilterSettings& f) {
+    if (f.decimate > 1) obj["decimate"] = f.decimate;
+    if (f.statsWindow != 0) obj["stats_window"] = f.statsWindow;
+    if (f.deadband > 0) obj["deadband"] = f.deadband;
+    if (f.reportIntervalMs != 0) obj["report_interval_ms"] = f.reportIntervalMs;
+  }
+
+  // Replace the channel tables from the snapshot if it was made from
+  // the JSON with this hash. Leaves everything untouched otherwise.
+  bool loadSnapshot(uint32_t sourceHash) {
+    File file = SD.open(SNAPSHOT_FILE, FILE_READ);
+    if (!file) return false;
+
+    SnapshotHeader header;
+    bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              header.magic == SNAPSHOT_MAGIC && header.version == SNAPSHOT_VERSION &&
+              header.sourceHash == sourceHash;
+
+    std::vector<FixedChannel> fixed;
+    std::vector<I2CChannel> i2c;
+    if (ok) {
+      uint32_t crc = logCrc32((const uint8_t*)&header, offsetof(SnapshotHeader, crc));
+
+      fixed.reserve(header.fixedCount);
+      for (uint16_t i = 0; ok && i < header.fixedCount; i++) {
+        SnapshotFixed rec;
+        ok = file.read((uint8_t*)&rec, sizeof(rec)) == sizeof(rec);
+        crc = logCrc32((const uint8_t*)&rec, sizeof(rec), crc);
+        FixedChannel fc;
+        fc.channel = rec.channel;
+        fc.pin = rec.pin;
+        fc.mode = channelTypeName((ChannelType)rec.type);
+        fc.active = rec.active;
+        fc.sensor = rec.sensor;
+        fc.periodUs = rec.periodUs;
+        fc.spiClockHz = rec.spiClockHz;
+        fc.spiMode = rec.spiMode;
+        fc.spiCommand = rec.spiCommand;
+        fc.spiLength = rec.spiLength;
+        fc.filter = rec.filter;
+        fixed.push_back(fc);
+      }
+
+      i2c.reserve(header.i2cCount);
+      for (uint16_t i = 0; ok && i < header.i2cCount; i++) {
+        SnapshotI2C rec;
+        ok = file.read((uint8_t*)&rec, sizeof(rec)) == sizeof(rec);
+        crc = logCrc32((const uint8_t*)&rec, sizeof(rec), crc);
+        I2CChannel ic;
+        ic.channel = rec.channel;
+        ic.id = rec.id;
+        ic.address = rec.address;
+        ic.active = rec.active;
+        ic.reg = rec.reg;
+        ic.length = rec.length;
+        ic.missing = rec.flags & SNAPSHOT_I2C_MISSING;
+        ic.periodUs = rec.periodUs;
+        ic.filter = rec.filter;
+        if (rec.driver > 0) {
+          ok = ok && rec.driver <= I2C_BUILTIN_DRIVERS;
+          if (ok) ic.driver = i2cDriverRegistry().drivers[rec.driver - 1]->name;
+        }
+        i2c.push_back(ic);
+      }
+
+      ok = ok && crc == header.crc;
+    }
+    file.close();
+    if (!ok) return false;
+
+    fixedChannels.swap(fixed);
+    i2cChannels.swap(i2c);
+    oneWireResolution = header.oneWireResolution;
+    i2cEngine.setClock(header.i2cClockHz);
+    adcStreamHz = header.adcStreamHz;
+    adcOversample = header.adcOversample;
+    adcSmoothing = header.adcSmoothing;
+    return true;
+  }
+
+  // Write the channel tables as a snapshot of the JSON with this hash
+  bool writeSnapshot(uint32_t sourceHash) {
+    std::vector<SnapshotFixed> fixed(fixedChannels.size());
+    for (size_t i = 0; i < fixedChannels.size(); i++) {
+      const FixedChannel& ch = fixedChannels[i];
+      ChannelType type = channelTypeFromMode(ch.mode.c_str());
+      if (type == CH_NONE) {
+        // Unknown mode strings only survive in JSON
+        SD.remove(SNAPSHOT_FILE);
+        return false;
+      }
+      fixed[i] = {(int16_t)ch.channel, (int16_t)ch.pin, (uint8_t)type, ch.active,
+                  (uint8_t)ch.sensor, 0, ch.periodUs, ch.spiClockHz, ch.spiMode,
+                  ch.spiCommand, ch.spiLength, 0, ch.filter};
+    }
+
+    std::vector<SnapshotI2C> i2c(i2cChannels.size());
+    for (size_t i = 0; i < i2cChannels.size(); i++) {
+      const I2CChannel& ch = i2cChannels[i];
+      int driver = ch.driver.length() ? i2cBuiltinDriverIndex(ch.driver.c_str()) : -1;
+      if (ch.driver.length() && driver < 0) {
+        // Registered drivers can change between builds, only JSON names them
+        SD.remove(SNAPSHOT_FILE);
+        return false;
+      }
+      i2c[i] = {(int16_t)ch.channel, (int16_t)ch.id, (int16_t)ch.reg, ch.address, ch.active,
+                ch.length, (uint8_t)(ch.missing ? SNAPSHOT_I2C_MISSING : 0),
+                (uint8_t)(driver + 1), 0, ch.periodUs, ch.filter};
+    }
+
+    SnapshotHeader header = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, (uint16_t)fixed.size(),
+                             (uint16_t)i2c.size(), oneWireResolution, 0,
+                             i2cEngine.getClock(), adcStreamHz, adcOversample, adcSmoothing, 0,
+                             sourceHash, 0};
+    uint32_t crc = logCrc32((const uint8_t*)&header, offsetof(SnapshotHeader, crc));
+    crc = logCrc32((const uint8_t*)fixed.data(), fixed.size() * sizeof(SnapshotFixed), crc);
+    crc = logCrc32((const uint8_t*)i2c.data(), i2c.size() * sizeof(SnapshotI2C), crc);
+    header.crc = crc;
+
+    SD.remove(SNAPSHOT_FILE);  // Replace it: FILE_WRITE appends with some SD libraries
+    File file = SD.open(SNAPSHOT_FILE, FILE_WRITE);
+    if (!file) return false;
+    size_t expected = sizeof(header) + fixed.size() * sizeof(SnapshotFixed) +
+                      i2c.size() * sizeof(SnapshotI2C);
+    size_t written = file.write((const uint8_t*)&header, sizeof(header));
+    written += file.write((const uint8_t*)fixed.data(), fixed.size() * sizeof(SnapshotFixed));
+    written += file.write((const uint8_t*)i2c.data(), i2c.size() * sizeof(SnapshotI2C));
+    file.close();
+    return written == expected;  // A torn snapshot fails its CRC and is ignored
+  }
+
+  // Pin setup and table rebuild after the channel vectors were replaced
+  void applyLoadedConfig() {
+#if defined(BOARD_PROFILE)
+    applyBoardProfile();  // Pins were set up by begin()
+#else
+    for (const auto& ch : fixedChannels) {
+      if (ch.active) setupPin(ch.pin, ch.mode);
+    }
+#endif
+    rebuildChannelTable();
+    dirty = false;
+  }
+  
+  // Find the edge counter already on this pin, or start a new one.
+  // Counts survive config changes as long as the pin keeps an edge mode.
+  int claimEdgeCounter(int pin, bool* used) {
+    for (int i = 0; i < MAX_EDGE_COUNTERS; i++) {
+      if (edgeCounters[i].getPin() == pin) {
+        used[i] = true;
+        return i;
+      }
+    }
+    for (int i = 0; i < MAX_EDGE_COUNTERS; i++) {
+      if (!used[i] && edgeCounters[i].getPin() < 0) {
+        edgeCounters[i].begin(pin);
+        used[i] = true;
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // Find the DS18B20 bus already driving this pin, or start a new one
+  int claimOneWireBus(int pin, bool* used) {
+    for (int i = 0; i < MAX_ONEWIRE_BUSES; i++) {
+      if (oneWireBuses[i].getPin() == pin) {
+        used[i] = true;
+        return i;
+      }
+    }
+    for (int i = 0; i < MAX_ONEWIRE_BUSES; i++) {
+      if (!used[i] && oneWireBuses[i].getPin() < 0) {
+        oneWireBuses[i].begin(pin, oneWireResolution);
+        used[i] = true;
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // syncI2CChannels() up to the rebuild: the discovery map, written by
+  // scans, is read and the I2C channel vector changed under the scan lock
+  int applyI2CDiscovery() {
+    ScanLock lock(scanMutex);
+    i2cDiscovery.clearChanges();
+    int changes = 0;
+    int nextChannel = MAX_FIXED_CHANNELS + 1;
+    for (const auto& ch : i2cChannels) nextChannel = std::max(nextChannel, ch.channel + 1);
+
+    for (auto& ch : i2cChannels) {
+      if (ch.active && i2cDiscovery.isAbsent(ch.address)) {
+        ch.active = false;
+        ch.missing = true;
+        changes++;
+        LOG_WARN("I2C Channel %d (0x%02X) not responding, deactivated", ch.channel, ch.address);
+      } else if (ch.missing && i2cDiscovery.isPresent(ch.address)) {
+        ch.active = true;
+        ch.missing = false;
+        changes++;
+        LOG_INFO("I2C Channel %d (0x%02X) is back, reactivated", ch.channel, ch.address);
+      }
+    }
+
+    for (uint8_t address = I2C_FIRST_ADDRESS; address <= I2C_LAST_ADDRESS; address++) {
+      if (!i2cDiscovery.isPresent(address) || hasI2CAddress(address)) continue;
+      I2CChannel ic;
+      ic.channel = nextChannel++;
+      ic.id = i2cChannels.size();
+      ic.address = address;
+      ic.active = true;
+      ic.reg = -1;
+      ic.length = 0;
+      ic.missing = false;
+      ic.periodUs = 0;
+      ic.driver = "";
+      ic.filter = FilterSettings();
+      i2cChannels.push_back(ic);
+      changes++;
+      LOG_INFO("Found I2C device at 0x%02X, added as channel %d", address, ic.channel);
+    }
+    return changes;
+  }
+
+#if defined(BOARD_PROFILE)
+  // Fixed channels from the profile. Loaded entries for the same channel
+  // keep their active flag, rate and filter; their wiring is ignored.
+  void applyBoardProfile() {
+    std::vector<FixedChannel> fixed;
+    fixed.reserve(FixedProfile::count());
+    const ProfileChannel* p = FixedProfile::channels();
+    for (size_t i = 0; i < FixedProfile::count(); i++) {
+      FixedChannel fc = {p[i].channel, p[i].pin, channelTypeName(p[i].type), true,
+                         p[i].sensor, 0, p[i].spiClockHz, p[i].spiMode, p[i].spiCommand,
+                         p[i].spiLength, FilterSettings()};
+      for (const auto& loaded : fixedChannels) {
+        if (loaded.channel != fc.channel) continue;
+        fc.active = loaded.active;
+        fc.periodUs = loaded.periodUs;
+        fc.filter = loaded.filter;
+      }
+      fixed.push_back(fc);
+    }
+    fixedChannels.swap(fixed);
+  }
+#endif
   
 public:
   bool begin() {
     // Initialize I2C
     Wire.begin(I2C_SDA, I2C_SCL);
-    Serial.println("I2C initialized");
+    i2cEngine.setClock(i2cEngine.getClock());
+    LOG_INFO("I2C initialized");
+
+#if defined(BOARD_PROFILE)
+    // Fixed channels scan from here on, with or without a config file
+    FixedProfile::setupPins();
+    applyBoardProfile();
+    rebuildChannelTable();
+#endif
     
     // Initialize SD card
     SPI.begin(SD_SCK, SD_MISO, SD_MOSI, SD_CS);
+    spiEngine.setArbiter(&spiBus);
     if (!SD.begin(SD_CS)) {
-      Serial.println("SD Card initialization failed!");
+      LOG_ERROR("SD Card initialization failed!");
       return false;
     }
-    Serial.println("SD Card initialized");
+    LOG_INFO("SD Card initialized");
     return true;
   }
 
-  bool loadConfig() {
-    File file = SD.open(CONFIG_FILE, FILE_READ);
+  // Uses the binary snapshot when it matches config.json;
+  // useSnapshot = false forces the JSON parse (e.g. to compare boot times)
+  bool loadConfig(bool useSnapshot = true) {
+    bootStats.loadStartUs = micros();
+    bootStats.firstSampleUs = 0;
+
+    bool ok = loadConfigFrom(CONFIG_FILE, useSnapshot);
+
+    // A crash between the renames in saveConfig() leaves only the backup
+    if (!ok && SD.exists(CONFIG_BACKUP_FILE) && loadConfigFrom(CONFIG_BACKUP_FILE, false)) {
+      LOG_WARN("Recovered config from backup");
+      ok = true;
+    }
+
+    bootStats.configLoadUs = micros() - bootStats.loadStartUs;
+    return ok;
+  }
+
+  bool loadConfigFrom(const char* path, bool useSnapshot) {
+    File file = SD.open(path, FILE_READ);
     if (!file) {
-      Serial.println("Failed to open config file");
+      LOG_WARN("Failed to open config file %s", path);
       return false;
     }
 
+    // Hashing the JSON is much cheaper than parsing it
+    uint32_t hash = hashFile(file);
+    if (useSnapshot && loadSnapshot(hash)) {
+      file.close();
+      applyLoadedConfig();
+      bootStats.fromSnapshot = true;
+      LOG_INFO("Config loaded from snapshot");
+      return true;
+    }
+    file.seek(0);
+
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, file);
     file.close();
 
     if (error) {
-      Serial.print("deserializeJson() failed: ");
-      Serial.println(error.c_str());
+      LOG_ERROR("deserializeJson() failed: %s", error.c_str());
       return false;
     }
 
+    oneWireResolution = doc["onewire_resolution"] | 12;
+    i2cEngine.setClock(doc["i2c_clock_hz"] | I2C_DEFAULT_CLOCK);
+    adcStreamHz = doc["adc_continuous_hz"] | 0;
+    adcOversample = doc["adc_oversample"] | ADC_DEFAULT_OVERSAMPLE;
+    adcSmoothing = doc["adc_smoothing"] | 0;
+
     // Load fixed channels
     fixedChannels.clear();
     JsonArray fixed = doc["fixed_channels"];
@@ -88,12 +500,14 @@ public:
       fc.pin = ch["pin"];
       fc.mode = ch["mode"].as<String>();
       fc.active = ch["active"];
+      fc.sensor = ch["sensor"] | 0;
+      fc.periodUs = periodFromJson(ch);
+      fc.spiClockHz = ch["spi_clock_hz"] | 0;
+      fc.spiMode = ch["spi_mode"] | 0;
+      fc.spiCommand = ch["spi_command"] | 0;
+      fc.spiLength = ch["spi_length"] | 0;
+      fc.filter = filterFromJson(ch);
       fixedChannels.push_back(fc);
-      
-      // Setup pin mode if active
-      if (fc.active) {
-        setupPin(fc.pin, fc.mode);
-      }
     }
 
     // Load I2C channels
@@ -105,15 +519,35 @@ public:
       ic.id = ch["id"];
       ic.address = ch["address"];
       ic.active = ch["active"];
+      ic.reg = ch["reg"] | -1;
+      ic.length = ch["length"] | 0;
+      ic.missing = ch["missing"] | false;
+      ic.periodUs = periodFromJson(ch);
+      ic.driver = ch["driver"] | "";
+      ic.filter = filterFromJson(ch);
       i2cChannels.push_back(ic);
     }
 
-    Serial.println("Config loaded successfully");
+    applyLoadedConfig();
+    bootStats.fromSnapshot = false;
+
+    // Refresh the snapshot so the next boot can skip the parse
+    if (strcmp(path, CONFIG_FILE) == 0) writeSnapshot(hash);
+
+    LOG_INFO("Config loaded successfully");
     return true;
   }
 
+  // Write the config as it is; the tables and runtime state are left alone
   bool saveConfig() {
     JsonDocument doc;
+    doc["onewire_resolution"] = oneWireResolution;
+    doc["i2c_clock_hz"] = i2cEngine.getClock();
+    if (adcStreamHz > 0) {
+      doc["adc_continuous_hz"] = adcStreamHz;
+      doc["adc_oversample"] = adcOversample;
+      if (adcSmoothing != 0) doc["adc_smoothing"] = adcSmoothing;
+    }
 
     // Save fixed channels
     JsonArray fixed = doc.createNestedArray("fixed_channels");
@@ -123,6 +557,13 @@ public:
       obj["pin"] = ch.pin;
       obj["mode"] = ch.mode;
       obj["active"] = ch.active;
+      if (ch.sensor != 0) obj["sensor"] = ch.sensor;
+      periodToJson(obj, ch.periodUs);
+      if (ch.spiClockHz != 0) obj["spi_clock_hz"] = ch.spiClockHz;
+      if (ch.spiMode != 0) obj["spi_mode"] = ch.spiMode;
+      if (ch.spiCommand != 0) obj["spi_command"] = ch.spiCommand;
+      if (ch.spiLength != 0) obj["spi_length"] = ch.spiLength;
+      filterToJson(obj, ch.filter);
     }
 
     // Save I2C channels
@@ -133,21 +574,82 @@ public:
       obj["id"] = ch.id;
       obj["address"] = ch.address;
       obj["active"] = ch.active;
+      if (ch.reg >= 0) obj["reg"] = ch.reg;
+      if (ch.length != 0) obj["length"] = ch.length;
+      if (ch.missing) obj["missing"] = true;
+      periodToJson(obj, ch.periodUs);
+      if (ch.driver.length()) obj["driver"] = ch.driver;
+      filterToJson(obj, ch.filter);
     }
 
-    File file = SD.open(CONFIG_FILE, FILE_WRITE);
+    // Write compact JSON to a temp file, then swap it in. The old config
+    // survives as the backup until the new one is completely on the card.
+    // A temp file left by a crash is removed first: FILE_WRITE appends
+    // with some SD libraries.
+    SD.remove(CONFIG_TEMP_FILE);
+    File file = SD.open(CONFIG_TEMP_FILE, FILE_WRITE);
     if (!file) {
-      Serial.println("Failed to open config file for writing");
+      LOG_ERROR("Failed to open config file for writing");
       return false;
     }
 
-    serializeJsonPretty(doc, file);
+    String json;
+    serializeJson(doc, json);
+    size_t written = file.write((const uint8_t*)json.c_str(), json.length());
     file.close();
-    
-    Serial.println("Config saved successfully");
+
+    if (written != json.length()) {
+      LOG_ERROR("Config write incomplete, keeping previous config");
+      SD.remove(CONFIG_TEMP_FILE);
+      return false;
+    }
+
+    if (SD.exists(CONFIG_FILE)) {
+      SD.remove(CONFIG_BACKUP_FILE);
+      SD.rename(CONFIG_FILE, CONFIG_BACKUP_FILE);
+    }
+    if (!SD.rename(CONFIG_TEMP_FILE, CONFIG_FILE)) {
+      LOG_ERROR("Failed to replace config file");
+      return false;
+    }
+
+    dirty = false;
+    writeSnapshot(logCrc32((const uint8_t*)json.c_str(), json.length()));
+    LOG_INFO("Config saved successfully");
     return true;
   }
 
+  // Group several channel changes into a single config write:
+  //   config.beginBatch(); ...addI2C()/updateChannel()... config.commit();
+  void beginBatch() {
+    batchDepth++;
+  }
+
+  // Close a batch; the outermost commit() writes once if anything changed
+  bool commit() {
+    if (batchDepth > 0) batchDepth--;
+    if (batchDepth > 0 || !dirty) return true;
+    return saveConfig();
+  }
+
+  bool inBatch() const {
+    return batchDepth > 0;
+  }
+
+  bool isDirty() const {
+    return dirty;
+  }
+
+  // Called by the channel API after every change, and by anything that
+  // edited getFixedChannels()/getI2CChannels() directly: recompile the
+  // tables now, write to SD now or at the end of the current batch
+  bool markChanged() {
+    rebuildChannelTable();
+    dirty = true;
+    if (batchDepth > 0) return true;
+    return saveConfig();
+  }
+
   void setupPin(int pin, String mode) {
     if (mode == "DIGITAL") {
       pinMode(pin, INPUT);
@@ -155,12 +657,669 @@ public:
       pinMode(pin, INPUT);
     } else if (mode == "ONEWIRE") {
       pinMode(pin, INPUT);
+    } else if (mode == "COUNTER" || mode == "FREQUENCY" || mode == "DUTY") {
+      pinMode(pin, INPUT);  // Interrupt attached when the channel table is rebuilt
     } else if (mode == "SPI") {
       pinMode(pin, OUTPUT);
       digitalWrite(pin, HIGH);  // CS pin HIGH (inactive)
     }
   }
 
+  // Recompile the channel table and scan plan from the fixed and I2C vectors
+  void rebuildChannelTable() {
+    ScanLock lock(scanMutex);
+    int maxChannel = -1;
+    for (const auto& ch : fixedChannels) maxChannel = std::max(maxChannel, ch.channel);
+    for (const auto& ch : i2cChannels) maxChannel = std::max(maxChannel, ch.channel);
+    channelTable.reset(maxChannel);
+
+    bool busUsed[MAX_ONEWIRE_BUSES] = {false};
+    bool counterUsed[MAX_EDGE_COUNTERS] = {false};
+    for (size_t i = 0; i < fixedChannels.size(); i++) {
+      const FixedChannel& ch = fixedChannels[i];
+      if (!ch.active) continue;
+      ChannelSlot slot = {channelTypeFromMode(ch.mode.c_str()), 0, (int16_t)ch.pin,
+                          (uint16_t)i, 0, 0};
+      if (slot.type == CH_ONEWIRE) {
+        int bus = claimOneWireBus(ch.pin, busUsed);
+        if (bus < 0) {
+          LOG_WARN("Channel %d: no free OneWire bus (max %d pins)",
+                        ch.channel, MAX_ONEWIRE_BUSES);
+          continue;
+        }
+        slot.unit = bus;
+        slot.sub = ch.sensor;
+      } else if (slot.type == CH_DIGITAL) {
+        // Decoded from the scan's GPIO register snapshot
+        slot.unit = GpioSnapshot::bankOf(ch.pin);
+        slot.sub = GpioSnapshot::bitOf(ch.pin);
+      } else if (slot.type == CH_COUNTER || slot.type == CH_FREQUENCY || slot.type == CH_DUTY) {
+        int counter = claimEdgeCounter(ch.pin, counterUsed);
+        if (counter < 0) {
+          LOG_WARN("Channel %d: no free edge counter (max %d pins)",
+                        ch.channel, MAX_EDGE_COUNTERS);
+          continue;
+        }
+        slot.unit = counter;
+      }
+      channelTable.assign(ch.channel, slot);
+    }
+
+    // Release buses whose pin no longer has an active ONEWIRE channel
+    for (int i = 0; i < MAX_ONEWIRE_BUSES; i++) {
+      if (!busUsed[i]) oneWireBuses[i].end();
+    }
+    for (int i = 0; i < MAX_EDGE_COUNTERS; i++) {
+      if (!counterUsed[i]) edgeCounters[i].end();
+    }
+
+    // Drivers are looked up here, a read only calls through the pointer
+    i2cDevices.resize(i2cChannels.size());
+    for (size_t i = 0; i < i2cChannels.size(); i++) {
+      const I2CChannel& ch = i2cChannels[i];
+      if (!ch.active) continue;
+      const I2CDriver* driver = findI2CDriver(ch.driver.c_str());
+      if (!driver) {
+        LOG_WARN("I2C Channel %d: unknown driver '%s'", ch.channel, ch.driver.c_str());
+        continue;
+      }
+      i2cDevices[i].resolve(driver, ch.address, ch.reg, ch.length);
+      channelTable.assign(ch.channel, {CH_I2C, ch.address, -1, (uint16_t)i, 0, 0});
+    }
+
+    scanPlan.build(channelTable);
+    readStats.configure(channelTable.size());
+    scanValues = scanPlan.size();
+    for (uint16_t i = scanPlan.begin(BUS_I2C); i < scanPlan.end(BUS_I2C); i++) {
+      scanValues += i2cDevices[scanPlan.slotAt(i).index].valueCount() - 1;
+    }
+    rebuildFilters();
+    rebuildSchedule();
+    syncAdcStream();
+
+#if defined(BOARD_PROFILE)
+    bool matched = FixedProfile::matches(scanPlan, fixedChannels);
+    if (profileActive && !matched) {
+      LOG_INFO("Fixed channels changed at runtime, scanning with the channel table");
+    }
+    profileActive = profileEnabled && matched;
+#endif
+  }
+
+  // Stream every active ANALOG pin on ADC1 when continuous mode is on;
+  // restarts the ADC only if the pin set or settings changed
+  void syncAdcStream() {
+    uint8_t pins[ADC_MAX_CHANNELS];
+    uint8_t n = 0;
+    for (uint16_t i = scanPlan.begin(BUS_ADC); i < scanPlan.end(BUS_ADC); i++) {
+      int pin = scanPlan.slotAt(i).pin;
+      if (n < ADC_MAX_CHANNELS && adc1ChannelForPin(pin) >= 0) pins[n++] = pin;
+    }
+    if (adcStreamHz == 0 || n == 0) {
+      adcStream.end();
+    } else if (!adcStream.begin(pins, n, adcStreamHz, adcOversample, adcSmoothing)) {
+      LOG_ERROR("Continuous ADC failed to start, using single reads");
+    }
+  }
+
+  // Output stage state for channels with filter settings. Statistics
+  // and deadband references restart whenever the config changes.
+  void rebuildFilters() {
+    filters.clear();
+    filterBase.assign(channelTable.size(), -1);
+    for (uint16_t i = 0; i < scanPlan.size(); i++) {
+      const ChannelSlot& slot = scanPlan.slotAt(i);
+      const FilterSettings& settings = slot.type == CH_I2C ? i2cChannels[slot.index].filter
+                                                           : fixedChannels[slot.index].filter;
+      if (!settings.enabled()) continue;
+      size_t count = slot.type == CH_I2C ? i2cDevices[slot.index].valueCount() : 1;
+      filterBase[scanPlan.channelAt(i)] = filters.size();
+      filters.resize(filters.size() + count);
+      for (size_t k = filters.size() - count; k < filters.size(); k++) {
+        filters[k].configure(settings);
+      }
+    }
+  }
+
+  // One deadline per plan entry; every channel is due right away
+  void rebuildSchedule() {
+    std::vector<uint32_t> periods(scanPlan.size());
+    std::vector<uint8_t> counts(scanPlan.size(), 1);
+    for (uint16_t i = 0; i < scanPlan.size(); i++) {
+      const ChannelSlot& slot = scanPlan.slotAt(i);
+      uint32_t period = slot.type == CH_I2C ? i2cChannels[slot.index].periodUs
+                                            : fixedChannels[slot.index].periodUs;
+      periods[i] = period ? period : defaultPeriodUs;
+      if (slot.type == CH_I2C) counts[i] = i2cDevices[slot.index].valueCount();
+    }
+    scheduler.build(periods, counts, micros());
+    dueList.assign(scanPlan.size(), 0);
+  }
+
+  // O(1) channel lookup for the read path, nullptr if inactive or missing
+  const ChannelSlot* findChannel(int channel) const {
+    return channelTable.find(channel);
+  }
+
+  // Read one resolved channel without printing
+  SampleStatus readSlot(const ChannelSlot& slot, float& value) {
+    switch (slot.type) {
+      case CH_DIGITAL:
+        value = digitalRead(slot.pin);
+        return SAMPLE_OK;
+
+      case CH_ANALOG:
+        return readAnalogPin(slot.pin, value);
+
+      case CH_ONEWIRE: {
+        // Starts or collects a bus-wide conversion, never waits for one
+        DS18B20Bus& bus = oneWireBuses[slot.unit];
+        bus.service(millis());
+        return bus.read(slot.sub, value);
+      }
+
+      case CH_SPI: {
+        // [command] + response bytes with the channel's clock and mode
+        const FixedChannel& ch = fixedChannels[slot.index];
+        return readSpiPin(slot.pin, ch.spiClockHz, ch.spiMode, ch.spiCommand, ch.spiLength,
+                          value);
+      }
+
+      case CH_I2C: {
+        // First value of the device's burst read (see readChannelValues())
+        float values[I2C_MAX_VALUES] = {0};
+        SampleStatus status = i2cDevices[slot.index].read(i2cEngine, values, millis());
+        value = values[0];
+        return status;
+      }
+
+      case CH_COUNTER:
+      case CH_FREQUENCY:
+      case CH_DUTY:
+        // Counted by interrupt, nothing to poll
+        return edgeCounters[slot.unit].read(slot.type, micros(), value);
+
+      default:
+        return SAMPLE_ERROR;
+    }
+  }
+
+  // Single-bus reads, shared by readSlot() and the board profile's scan
+
+  SampleStatus readAnalogPin(int pin, float& value) {
+    // Continuous mode: latest filtered mV, the ADC is not touched here
+    if (adcStream.streams(pin)) return adcStream.read(pin, value);
+    value = analogRead(pin);
+    return SAMPLE_OK;
+  }
+
+  SampleStatus readSpiPin(int pin, uint32_t clockHz, uint8_t mode, uint8_t command,
+                          uint8_t length, float& value) {
+    return spiEngine.read(pin, clockHz, mode, command, length, value);
+  }
+
+  // Around a scan's readSpiPin() calls: one hold of the bus, and one
+  // transaction per run of channels with the same settings
+  void beginSpiBatch() {
+    spiEngine.beginBatch();
+  }
+
+  void endSpiBatch() {
+    spiEngine.endBatch();
+  }
+
+  // Bus instances are claimed at runtime, so these look them up by plan entry
+  SampleStatus readOneWireAt(uint16_t at, uint8_t sensor, float& value) {
+    DS18B20Bus& bus = oneWireBuses[scanPlan.slotAt(at).unit];
+    bus.service(millis());
+    return bus.read(sensor, value);
+  }
+
+  SampleStatus readEdgeAt(uint16_t at, ChannelType type, float& value) {
+    return edgeCounters[scanPlan.slotAt(at).unit].read(type, micros(), value);
+  }
+
+  // readSlot(), but DIGITAL channels decode the scan's GPIO snapshot
+  SampleStatus readScanSlot(const ChannelSlot& slot, const GpioSnapshot& gpio, float& value) {
+    if (slot.type == CH_DIGITAL) {
+      value = gpio.level(slot.unit, slot.sub);
+      return SAMPLE_OK;
+    }
+    return readSlot(slot, value);
+  }
+
+  // Read plan entry i into the frame at n. An I2C driver channel fills
+  // one entry per value from a single burst, numbered by frame.sub.
+  // Returns the entries written, 0 if they don't fit below limit.
+  size_t readScanEntry(uint16_t i, const GpioSnapshot& gpio, uint32_t readUs,
+                       ScanFrame& frame, size_t n, size_t limit) {
+    const ChannelSlot& slot = scanPlan.slotAt(i);
+    bool timed = readStats.isEnabled();
+    uint32_t start = timed ? cycleCount() : 0;
+    if (slot.type == CH_I2C) {
+      I2CDevice& device = i2cDevices[slot.index];
+      size_t count = device.valueCount();
+      if (n + count > limit) return 0;
+      bool failing = timed && i2cEngine.getHealth(slot.address).failures > 0;
+      float values[I2C_MAX_VALUES] = {0};
+      SampleStatus status = device.read(i2cEngine, values, millis());
+      if (timed) noteRead(scanPlan.channelAt(i), slot, status, start, failing);
+      for (size_t k = 0; k < count; k++) {
+        frame.status[n + k] = status;
+        frame.value[n + k] = values[k];
+        frame.timestampUs[n + k] = readUs;
+        frame.channel[n + k] = scanPlan.channelAt(i);
+        frame.sub[n + k] = k;
+      }
+      return count;
+    }
+    if (n >= limit) return 0;
+    float value = 0;
+    frame.status[n] = readScanSlot(slot, gpio, value);
+    if (timed) noteRead(scanPlan.channelAt(i), slot, (SampleStatus)frame.status[n], start, false);
+    frame.value[n] = value;
+    frame.timestampUs[n] = readUs;
+    frame.channel[n] = scanPlan.channelAt(i);
+    frame.sub[n] = 0;
+    return 1;
+  }
+
+  // Count a finished read in readStats; failing: an I2C device that had
+  // failed before, so a read that got through to it is a retry
+  void noteRead(int channel, const ChannelSlot& slot, SampleStatus status, uint32_t start,
+                bool failing) {
+    readStats.recordRead(channel, busForType(slot.type), status, cycleCount() - start,
+                         failing && status != SAMPLE_SKIPPED);
+  }
+
+  // readSlot() counted in readStats. Single reads from loop() share the
+  // OneWire, SPI and I2C state with the scan on the other core, so they
+  // take the scan lock too.
+  SampleStatus readTimed(int channel, const ChannelSlot& slot, float& value) {
+    ScanLock lock(scanMutex);
+    if (!readStats.isEnabled()) return readSlot(slot, value);
+    bool failing = slot.type == CH_I2C && i2cEngine.getHealth(slot.address).failures > 0;
+    uint32_t start = cycleCount();
+    SampleStatus status = readSlot(slot, value);
+    noteRead(channel, slot, status, start, failing);
+    return status;
+  }
+
+  // Every value of a channel from one read: an I2C driver's sub-channels,
+  // one value otherwise. Returns the count written (up to I2C_MAX_VALUES).
+  uint8_t readChannelValues(int channel, float* values, SampleStatus& status) {
+    ScanLock lock(scanMutex);
+    const ChannelSlot* slot = findChannel(channel);
+    if (!slot) {
+      status = SAMPLE_NO_DEVICE;
+      return 0;
+    }
+    if (slot->type != CH_I2C) {
+      status = readTimed(channel, *slot, values[0]);
+      return 1;
+    }
+    I2CDevice& device = i2cDevices[slot->index];
+    for (uint8_t k = 0; k < device.valueCount(); k++) values[k] = 0;
+    bool timed = readStats.isEnabled();
+    bool failing = timed && i2cEngine.getHealth(slot->address).failures > 0;
+    uint32_t start = timed ? cycleCount() : 0;
+    status = device.read(i2cEngine, values, millis());
+    if (timed) noteRead(channel, *slot, status, start, failing);
+    return device.valueCount();
+  }
+
+  // Number of samples one scanAll() produces (I2C driver channels count
+  // once per value); size ScanFrames with this
+  size_t scanSize() const {
+    return scanValues;
+  }
+
+  // Grow a frame that no longer holds a whole scan because channels were
+  // added since it was sized. Call between scans, under the scan lock.
+  void fitFrame(ScanFrame& frame) const {
+    if (frame.capacity() < scanValues) frame.reserve(scanValues);
+  }
+
+  // Scan values dropped because the frame passed to scanAll() was too small
+  uint32_t getTruncatedValues() const {
+    ScanLock lock(scanMutex);
+    return truncatedValues;
+  }
+
+  // Read every active channel, bus by bus, into a preallocated frame.
+  // Returns the number of samples written (capped at frame.capacity()).
+  size_t scanAll(ScanFrame& frame) {
+    ScanLock lock(scanMutex);
+    uint32_t scanStart = cycleCount();
+    size_t n = 0;
+    size_t limit = std::min(scanValues, frame.capacity());
+    truncatedValues += scanValues - limit;
+
+    // Every DIGITAL channel comes from one read of the input registers,
+    // stamped with the time of that read
+    uint32_t lastUs = micros();
+    frame.readStartUs = lastUs;
+    int firstBus = BUS_GPIO;
+#if defined(BOARD_PROFILE)
+    // Generated reads for the fixed buses, the plan only for I2C
+    if (profileActive) {
+      n = FixedProfile::scan(*this, frame, limit, lastUs);
+      firstBus = BUS_I2C;
+    }
+#endif
+    GpioSnapshot gpio;
+    if (firstBus == BUS_GPIO && scanPlan.begin(BUS_GPIO) < scanPlan.end(BUS_GPIO)) {
+      gpio.capture();
+    }
+
+    for (int b = firstBus; b < BUS_COUNT; b++) {
+      ScanBus bus = (ScanBus)b;
+      // I2C reads run back-to-back and their bus time is accumulated
+      if (bus == BUS_I2C) i2cEngine.beginSession();
+      // SPI reads share one hold of the bus (against SD logging)
+      bool spiBatch = bus == BUS_SPI && scanPlan.begin(bus) < scanPlan.end(bus);
+      if (spiBatch) spiEngine.beginBatch();
+      for (uint16_t i = scanPlan.begin(bus); i < scanPlan.end(bus); i++) {
+        if (bus != BUS_GPIO) lastUs = micros();
+        size_t written = readScanEntry(i, gpio, lastUs, frame, n, limit);
+        if (written == 0) break;
+        n += written;
+      }
+      if (bus == BUS_ADC) frame.alignedEndUs = lastUs;
+      if (spiBatch) spiEngine.endBatch();
+      if (bus == BUS_I2C) {
+        // A few discovery probes per scan find hot-plugged devices
+        if (discoveryPerScan) i2cDiscovery.step(i2cEngine, discoveryPerScan);
+        i2cEngine.endSession();
+      }
+    }
+
+    frame.count = n;
+    frame.readEndUs = lastUs;
+    if (n > 0) noteSample();
+    if (readStats.isEnabled()) readStats.recordScan(cycleCount() - scanStart);
+    return n;
+  }
+
+  // Read only the channels whose deadline has passed, in bus order.
+  // Returns the number of samples written; 0 when nothing was due.
+  size_t scanDue(ScanFrame& frame) {
+    ScanLock lock(scanMutex);
+    uint32_t scanStart = cycleCount();
+    uint32_t now = micros();
+    // Only what fits in the frame; the rest stays due for the next call
+    size_t due = scheduler.collectDue(now, dueList.data(), frame.capacity());
+    std::sort(dueList.begin(), dueList.begin() + due);  // Plan order groups each bus
+
+    GpioSnapshot gpio;
+    bool gpioRead = false;
+    uint32_t gpioUs = now;
+    bool i2cOpen = false;
+    bool spiOpen = false;
+    size_t out = 0;
+    frame.readStartUs = frame.alignedEndUs = frame.readEndUs = now;
+    for (size_t n = 0; n < due; n++) {
+      uint16_t i = dueList[n];
+      const ChannelSlot& slot = scanPlan.slotAt(i);
+      if (slot.type == CH_DIGITAL && !gpioRead) {
+        gpioUs = micros();
+        gpio.capture();
+        gpioRead = true;
+      }
+      if (slot.type != CH_SPI && spiOpen) {
+        spiEngine.endBatch();
+        spiOpen = false;
+      }
+      if (slot.type == CH_SPI && !spiOpen) {
+        spiEngine.beginBatch();
+        spiOpen = true;
+      }
+      if (slot.type == CH_I2C && !i2cOpen) {
+        i2cEngine.beginSession();
+        i2cOpen = true;
+      }
+      uint32_t readUs = slot.type == CH_DIGITAL ? gpioUs : micros();
+      size_t written = readScanEntry(i, gpio, readUs, frame, out, frame.capacity());
+      if (written == 0) {
+        scheduler.markMissed(i);  // More values than the whole frame holds
+        continue;
+      }
+      out += written;
+      scheduler.markRead(i, readUs);
+      if (busForType(slot.type) <= BUS_ADC) frame.alignedEndUs = readUs;
+      frame.readEndUs = readUs;
+    }
+    if (spiOpen) spiEngine.endBatch();
+    if (i2cOpen) i2cEngine.endSession();
+
+    // Background discovery on its own interval, wakes here can be very frequent
+    if (discoveryPerScan && (int32_t)(now - nextDiscoveryUs) >= 0) {
+      i2cDiscovery.step(i2cEngine, discoveryPerScan);
+      nextDiscoveryUs = now + I2C_DISCOVERY_INTERVAL_US;
+    }
+
+    frame.count = out;
+    if (out > 0) noteSample();
+    if (due > 0 && readStats.isEnabled()) readStats.recordScan(cycleCount() - scanStart);
+    return out;
+  }
+
+  // Output stage: update each channel's window statistics and drop the
+  // samples its decimation and deadband settings filter out, compacting
+  // the frame in place. Returns the samples left.
+  size_t filterScan(ScanFrame& frame) {
+    ScanLock lock(scanMutex);
+    if (filters.empty()) return frame.count;
+    size_t out = 0;
+    for (size_t i = 0; i < frame.count; i++) {
+      int16_t channel = frame.channel[i];
+      int base = channel >= 0 && (size_t)channel < filterBase.size() ? filterBase[channel] : -1;
+      if (base >= 0 && !filters[base + frame.sub[i]].accept(frame.value[i], frame.status[i],
+                                                            frame.timestampUs[i])) {
+        continue;
+      }
+      if (out != i) {
+        frame.channel[out] = frame.channel[i];
+        frame.value[out] = frame.value[i];
+        frame.timestampUs[out] = frame.timestampUs[i];
+        frame.status[out] = frame.status[i];
+        frame.sub[out] = frame.sub[i];
+      }
+      out++;
+    }
+    frame.count = out;
+    return out;
+  }
+
+  // Output stage of a channel value, nullptr if it has no filter settings
+  const ChannelFilter* getChannelFilter(int channel, uint8_t sub = 0) const {
+    const ChannelSlot* slot = findChannel(channel);
+    if (!slot || filterBase[channel] < 0) return nullptr;
+    uint8_t count = slot->type == CH_I2C ? i2cDevices[slot->index].valueCount() : 1;
+    return sub < count ? &filters[filterBase[channel] + sub] : nullptr;
+  }
+
+  // Microseconds until scanDue() has something to read
+  uint32_t timeToNextDueUs() const {
+    ScanLock lock(scanMutex);
+    return scheduler.timeToNextUs(micros());
+  }
+
+  // Period for channels without sample_rate_hz/period_ms (not saved)
+  void setDefaultPeriodMs(uint32_t ms) {
+    ScanLock lock(scanMutex);
+    defaultPeriodUs = std::max<uint32_t>(ms, 1) * 1000UL;
+    rebuildSchedule();
+  }
+
+  // Jitter and missed-deadline counters for a channel, nullptr if inactive
+  const ChannelTiming* getChannelTiming(int channel) const {
+    for (uint16_t i = 0; i < scanPlan.size(); i++) {
+      if (scanPlan.channelAt(i) == channel) return scheduler.getTiming(i);
+    }
+    return nullptr;
+  }
+
+  void resetChannelTiming() {
+    ScanLock lock(scanMutex);
+    scheduler.resetStats();
+  }
+
+#if defined(BOARD_PROFILE)
+  // Off: scanAll() reads the fixed channels through the channel table too
+  void useBoardProfile(bool on) {
+    profileEnabled = on;
+    rebuildChannelTable();
+  }
+
+  // True while scanAll() reads the fixed channels with the profile's scan
+  bool boardProfileActive() const {
+    return profileActive;
+  }
+#endif
+
+  // Hold across a scan and its filterScan() so no rebuild falls in between
+  ScanMutex& getScanMutex() {
+    return scanMutex;
+  }
+
+  // Read latency histograms and status counts per channel, bus and scan
+  ReadStatsCollector& getReadStats() {
+    return readStats;
+  }
+
+  // Record time-to-first-sample after loadConfig()
+  void noteSample() {
+    if (bootStats.firstSampleUs == 0 && bootStats.loadStartUs != 0) {
+      bootStats.firstSampleUs = micros() - bootStats.loadStartUs;
+    }
+  }
+
+  const BootStats& getBootStats() const {
+    return bootStats;
+  }
+
+  // DS18B20 resolution in bits (9-12) for every OneWire bus, saved with config
+  void setOneWireResolution(uint8_t bits) {
+    oneWireResolution = constrain(bits, 9, 12);
+    for (int i = 0; i < MAX_ONEWIRE_BUSES; i++) {
+      oneWireBuses[i].setResolution(oneWireResolution);
+    }
+    markChanged();
+  }
+
+  // Number of DS18B20s found on a pin (0 until the first scan touches it)
+  int getOneWireDeviceCount(int pin) {
+    for (int i = 0; i < MAX_ONEWIRE_BUSES; i++) {
+      if (oneWireBuses[i].getPin() == pin) return oneWireBuses[i].getDeviceCount();
+    }
+    return 0;
+  }
+
+  // Continuous ADC for ANALOG channels on ADC1 pins (GPIO1-10): hz
+  // conversions per pin, oversample of them averaged into each value,
+  // smoothing = exponential filter weight 1/2^smoothing (0 = off).
+  // Streamed channels read in calibrated mV instead of raw counts.
+  // hz = 0 goes back to one analogRead() per read. Saved with config.
+  void setAnalogContinuous(uint32_t hz, uint16_t oversample = ADC_DEFAULT_OVERSAMPLE,
+                           uint8_t smoothing = 0) {
+    adcStreamHz = hz;
+    adcOversample = std::max<uint16_t>(oversample, 1);
+    adcSmoothing = smoothing;
+    markChanged();
+  }
+
+  bool isAnalogContinuous() const {
+    return adcStream.isRunning();
+  }
+
+  // Conversions demuxed since the stream (re)started
+  uint32_t getAdcConversionCount() const {
+    return adcStream.getDemux().conversionCount();
+  }
+
+  // Zero a COUNTER channel (and any edge channel sharing its pin)
+  bool resetEdgeCount(int channel) {
+    const ChannelSlot* slot = findChannel(channel);
+    if (!slot || (slot->type != CH_COUNTER && slot->type != CH_FREQUENCY &&
+                  slot->type != CH_DUTY)) {
+      return false;
+    }
+    edgeCounters[slot->unit].resetCount();
+    return true;
+  }
+
+  // SPI scans that skipped their reads because the SD card held the bus
+  uint32_t getSpiSkippedBatches() const {
+    return spiEngine.skippedBatchCount();
+  }
+
+  // SPI transactions begun so far (one per change of clock or mode)
+  uint32_t getSpiTransactionCount() const {
+    return spiEngine.transactionCount();
+  }
+
+  // I2C bus clock in Hz, saved with config
+  void setI2CClock(uint32_t hz) {
+    {
+      ScanLock lock(scanMutex);  // Not in the middle of a scan's transfers
+      i2cEngine.setClock(hz);
+    }
+    markChanged();
+  }
+
+  // Time spent in I2C transactions during the last scanAll()
+  uint32_t getI2CBusTimeUs() const {
+    return i2cEngine.getLastScanBusTimeUs();
+  }
+
+  const I2CDeviceHealth& getI2CHealth(uint8_t address) const {
+    return i2cEngine.getHealth(address);
+  }
+
+  // Probe the whole bus now and sync the I2C channels to what answered.
+  // Returns the number of channels added, deactivated or reactivated.
+  // Running acquisition waits for the probes (a few ms at the probe clock).
+  int discoverI2C() {
+    {
+      ScanLock lock(scanMutex);
+      i2cDiscovery.fullScan(i2cEngine);
+      LOG_INFO("I2C scan complete: %d devices found", i2cDiscovery.presentCount());
+    }
+    return syncI2CChannels();
+  }
+
+  // Background discovery: probe this many addresses per scanAll(), 0 = off.
+  // Call syncI2CChannels() when i2cChangesPending() to apply what it found.
+  void setI2CDiscoveryRate(uint8_t addressesPerScan) {
+    ScanLock lock(scanMutex);
+    discoveryPerScan = addressesPerScan;
+  }
+
+  // Safe from loop() while acquisition scans, like syncI2CChannels()
+  bool i2cChangesPending() const {
+    ScanLock lock(scanMutex);
+    return i2cDiscovery.hasChanges();
+  }
+
+  // Add channels for new devices, deactivate channels whose device is gone
+  // and reactivate ones that came back. Channels disabled by hand are left
+  // alone. One config write; returns the number of channels changed.
+  // Scans see the discovery map and the rebuilt tables only between scans,
+  // so this can run from loop() while acquisition runs on the other core.
+  int syncI2CChannels() {
+    int changes = applyI2CDiscovery();
+    if (changes > 0) markChanged();  // Rebuild under the lock, SD write outside it
+    return changes;
+  }
+
+  bool hasI2CAddress(uint8_t address) const {
+    for (const auto& ch : i2cChannels) {
+      if (ch.address == address) return true;
+    }
+    return false;
+  }
+
   // Get channel mode
   String getChannelMode(int channel) {
     // Check fixed channels
@@ -200,6 +1359,7 @@ public:
     return 0;
   }
 
+  // Direct edits take effect (and are saved) with markChanged()
   std::vector<FixedChannel>& getFixedChannels() {
     return fixedChannels;
   }
@@ -260,6 +1420,10 @@ public:
 };
 
 ConfigManager config;
+AcquisitionTask acquisition;
+SampleLogger sampleLogger;
+TelemetryStream telemetry;
+HistoryStore history;
 
 // ========== USER API FUNCTIONS ==========
 
@@ -277,24 +1441,27 @@ void updateChannel(int channel, String newMode) {
         config.setupPin(ch.pin, newMode);
       }
       
-      Serial.printf("Channel %d updated: %s (%s)\n", channel, newMode.c_str(), 
+      LOG_INFO("Channel %d updated: %s (%s)", channel, newMode.c_str(), 
                     ch.active ? "ACTIVE" : "DISABLED");
       break;
     }
   }
   
   if (!found) {
-    Serial.printf("Channel %d not found!\n", channel);
+    LOG_WARN("Channel %d not found!", channel);
   } else {
-    config.saveConfig();
+    config.markChanged();
   }
 }
 
 // Add I2C channel dynamically
-int addI2C(int channel, uint8_t address) {
+// reg: register to read (-1 = none), length: bytes to read (1-4, 0 = 2)
+// driver: decoder from I2CDrivers.h ("mpu6050", "bmp280", ...), "" = raw value
+int addI2C(int channel, uint8_t address, int reg = -1, uint8_t length = 0,
+           const char* driver = "") {
   // Validate channel number
   if (channel <= MAX_FIXED_CHANNELS) {
-    Serial.printf("Error: I2C channel %d must be > %d (reserved for fixed channels)\n", 
+    LOG_ERROR("Error: I2C channel %d must be > %d (reserved for fixed channels)", 
                   channel, MAX_FIXED_CHANNELS);
     return -1;
   }
@@ -304,11 +1471,17 @@ int addI2C(int channel, uint8_t address) {
   ic.id = config.getI2CChannels().size();
   ic.address = address;
   ic.active = true;
+  ic.reg = reg;
+  ic.length = length;
+  ic.missing = false;
+  ic.periodUs = 0;
+  ic.driver = driver;
+  ic.filter = FilterSettings();
   
   config.getI2CChannels().push_back(ic);
-  config.saveConfig();
+  config.markChanged();
   
-  Serial.printf("I2C Channel %d added: 0x%02X\n", channel, address);
+  LOG_INFO("I2C Channel %d added: 0x%02X", channel, address);
   return ic.id;
 }
 
@@ -321,10 +1494,10 @@ void removeI2C(int channel) {
   
   if (it != channels.end()) {
     channels.erase(it, channels.end());
-    config.saveConfig();
-    Serial.printf("I2C Channel %d removed\n", channel);
+    config.markChanged();
+    LOG_INFO("I2C Channel %d removed", channel);
   } else {
-    Serial.printf("I2C Channel %d not found!\n", channel);
+    LOG_WARN("I2C Channel %d not found!", channel);
   }
 }
 
@@ -334,8 +1507,8 @@ void disableChannel(int channel) {
   for (auto& ch : config.getFixedChannels()) {
     if (ch.channel == channel) {
       ch.active = false;
-      config.saveConfig();
-      Serial.printf("Channel %d disabled\n", channel);
+      config.markChanged();
+      LOG_INFO("Channel %d disabled", channel);
       return;
     }
   }
@@ -344,13 +1517,13 @@ void disableChannel(int channel) {
   for (auto& ch : config.getI2CChannels()) {
     if (ch.channel == channel) {
       ch.active = false;
-      config.saveConfig();
-      Serial.printf("I2C channel %d disabled\n", channel);
+      config.markChanged();
+      LOG_INFO("I2C channel %d disabled", channel);
       return;
     }
   }
   
-  Serial.printf("Channel %d not found\n", channel);
+  LOG_WARN("Channel %d not found", channel);
 }
 
 // Enable any channel (fixed or I2C)
@@ -360,8 +1533,8 @@ void enableChannel(int channel) {
     if (ch.channel == channel) {
       ch.active = true;
       config.setupPin(ch.pin, ch.mode);
-      config.saveConfig();
-      Serial.printf("Channel %d enabled\n", channel);
+      config.markChanged();
+      LOG_INFO("Channel %d enabled", channel);
       return;
     }
   }
@@ -370,99 +1543,334 @@ void enableChannel(int channel) {
   for (auto& ch : config.getI2CChannels()) {
     if (ch.channel == channel) {
       ch.active = true;
-      config.saveConfig();
-      Serial.printf("I2C channel %d enabled\n", channel);
+      config.markChanged();
+      LOG_INFO("I2C channel %d enabled", channel);
       return;
     }
   }
   
-  Serial.printf("Channel %d not found\n", channel);
+  LOG_WARN("Channel %d not found", channel);
 }
 
-// Read sensor from any channel
-float readChannel(int channel) {
-  String mode = config.getChannelMode(channel);
+// Set how an SPI channel is read: clockHz (0 = 1 MHz), mode 0-3, command
+// byte sent first (0 = none) and response bytes (1-4, big-endian)
+void setSpiChannel(int channel, uint32_t clockHz, uint8_t mode, uint8_t command = 0,
+                   uint8_t length = 1) {
+  for (auto& ch : config.getFixedChannels()) {
+    if (ch.channel == channel) {
+      ch.spiClockHz = clockHz;
+      ch.spiMode = mode & 3;
+      ch.spiCommand = command;
+      ch.spiLength = constrain(length, 1, SPI_MAX_RESPONSE);
+      config.markChanged();
+      LOG_INFO("Channel %d SPI: %lu Hz, mode %d, command 0x%02X, %d bytes", channel,
+               (unsigned long)clockHz, ch.spiMode, command, ch.spiLength);
+      return;
+    }
+  }
   
-  if (mode == "NONE") {
-    Serial.printf("Channel %d is not active or doesn't exist\n", channel);
-    return -1;
+  LOG_WARN("Channel %d not found!", channel);
+}
+
+// Output stage for a channel (fixed or I2C), see ChannelStats.h.
+// decimate: pass every Nth sample, deadband: pass only changes this large,
+// statsWindow: samples per min/max/mean/variance window (0 = off),
+// reportIntervalMs: pass at least this often despite the deadband (up to
+// MAX_REPORT_INTERVAL_MS)
+void setChannelFilter(int channel, uint16_t decimate, float deadband, uint16_t statsWindow = 0,
+                      uint32_t reportIntervalMs = 0) {
+  FilterSettings filter = {decimate, statsWindow, deadband,
+                           std::min<uint32_t>(reportIntervalMs, MAX_REPORT_INTERVAL_MS)};
+  
+  for (auto& ch : config.getFixedChannels()) {
+    if (ch.channel == channel) {
+      ch.filter = filter;
+      config.markChanged();
+      LOG_INFO("Channel %d filter: 1/%d, deadband %.3f, window %d", channel, decimate,
+               deadband, statsWindow);
+      return;
+    }
   }
   
-  if (mode == "DIGITAL") {
-    int pin = config.getChannelPin(channel);
-    int value = digitalRead(pin);
-    Serial.printf("Channel %d (Digital Pin %d): %d\n", channel, pin, value);
-    return value;
-    
-  } else if (mode == "ANALOG") {
-    int pin = config.getChannelPin(channel);
-    int value = analogRead(pin);
-    Serial.printf("Channel %d (Analog Pin %d): %d\n", channel, pin, value);
-    return value;
-    
-  } else if (mode == "ONEWIRE") {
-    int pin = config.getChannelPin(channel);
-    OneWire ow(pin);
-    
-    byte addr[8];
-    if (ow.search(addr)) {
-      // Found a device - implement your specific One-Wire protocol here
-      // Example: DS18B20 temperature sensor would need specific commands
-      Serial.printf("Channel %d (One-Wire Pin %d): Device found at address: ", channel, pin);
-      for(int i = 0; i < 8; i++) {
-        Serial.printf("%02X ", addr[i]);
-      }
-      Serial.println();
-      
-      // Return device address first byte as example
-      return addr[0];
-    } else {
-      Serial.printf("Channel %d (One-Wire Pin %d): No device found\n", channel, pin);
-      return -1;
+  for (auto& ch : config.getI2CChannels()) {
+    if (ch.channel == channel) {
+      ch.filter = filter;
+      config.markChanged();
+      LOG_INFO("I2C Channel %d filter: 1/%d, deadband %.3f, window %d", channel, decimate,
+               deadband, statsWindow);
+      return;
     }
-    
-  } else if (mode == "SPI") {
-    int csPin = config.getChannelPin(channel);
-    
-    // Example SPI read - modify based on your sensor protocol
-    digitalWrite(csPin, LOW);
-    byte value = SPI.transfer(0x00); // Read command varies by sensor
-    digitalWrite(csPin, HIGH);
-    
-    Serial.printf("Channel %d (SPI CS Pin %d): %d\n", channel, csPin, value);
-    return value;
-    
-  } else if (mode == "I2C") {
-    uint8_t address = config.getChannelI2CAddress(channel);
-    
-    // Check if device responds
-    Wire.beginTransmission(address);
-    int error = Wire.endTransmission();
-    
-    if (error == 0) {
-      // Device found - implement your specific I2C protocol here
-      // Example generic read
-      Wire.requestFrom(address, (uint8_t)2);
-      if (Wire.available() >= 2) {
-        byte msb = Wire.read();
-        byte lsb = Wire.read();
-        int value = (msb << 8) | lsb;
-        Serial.printf("Channel %d (I2C 0x%02X): %d\n", channel, address, value);
-        return value;
-      }
+  }
+  
+  LOG_WARN("Channel %d not found!", channel);
+}
+
+// Decode an I2C channel with a driver from I2CDrivers.h ("" = raw value)
+void setI2CDriver(int channel, const char* driver) {
+  if (!findI2CDriver(driver)) {
+    LOG_WARN("Unknown I2C driver '%s'", driver);
+    return;
+  }
+  
+  for (auto& ch : config.getI2CChannels()) {
+    if (ch.channel == channel) {
+      ch.driver = driver;
+      config.markChanged();
+      LOG_INFO("I2C Channel %d driver: %s", channel, *driver ? driver : "raw");
+      return;
+    }
+  }
+  
+  LOG_WARN("I2C Channel %d not found!", channel);
+}
+
+// ========== BACKGROUND ACQUISITION ==========
+
+// Set a channel's sampling rate for scanDue() (0 = default period)
+void setSampleRate(int channel, float hz) {
+  uint32_t periodUs = hz > 0 ? (uint32_t)(1000000.0f / hz + 0.5f) : 0;
+  
+  for (auto& ch : config.getFixedChannels()) {
+    if (ch.channel == channel) {
+      ch.periodUs = periodUs;
+      config.markChanged();
+      LOG_INFO("Channel %d sample rate: %.3f Hz", channel, hz);
+      return;
+    }
+  }
+  
+  for (auto& ch : config.getI2CChannels()) {
+    if (ch.channel == channel) {
+      ch.periodUs = periodUs;
+      config.markChanged();
+      LOG_INFO("I2C Channel %d sample rate: %.3f Hz", channel, hz);
+      return;
+    }
+  }
+  
+  LOG_WARN("Channel %d not found!", channel);
+}
+
+size_t acquisitionScan(ScanFrame& frame, void* context) {
+  ConfigManager* manager = (ConfigManager*)context;
+  ScanLock lock(manager->getScanMutex());
+  manager->fitFrame(frame);
+  manager->scanAll(frame);
+  return manager->filterScan(frame);
+}
+
+// Start scanning on its own core; drain samples with acquisition.drain().
+// Channels may change while it runs: the frame grows before the next scan
+// if they no longer fit.
+bool startAcquisition(uint32_t periodMs, int core = 0, size_t ringSize = 4096) {
+  if (!acquisition.start(acquisitionScan, &config, config.scanSize(), ringSize,
+                         periodMs, core)) {
+    LOG_ERROR("Failed to start acquisition task");
+    return false;
+  }
+  LOG_INFO("Acquisition started on core %d every %lu ms", core, (unsigned long)periodMs);
+  return true;
+}
+
+size_t acquisitionScanDue(ScanFrame& frame, void* context) {
+  ConfigManager* manager = (ConfigManager*)context;
+  ScanLock lock(manager->getScanMutex());
+  manager->fitFrame(frame);
+  manager->scanDue(frame);
+  return manager->filterScan(frame);
+}
+
+uint32_t acquisitionDelay(void* context) {
+  return ((ConfigManager*)context)->timeToNextDueUs();
+}
+
+// Like startAcquisition(), but each channel is read at its own rate and
+// the task sleeps until the next deadline
+bool startScheduledAcquisition(int core = 0, size_t ringSize = 4096) {
+  if (!acquisition.startScheduled(acquisitionScanDue, acquisitionDelay, &config,
+                                  config.scanSize(), ringSize, core)) {
+    LOG_ERROR("Failed to start acquisition task");
+    return false;
+  }
+  LOG_INFO("Scheduled acquisition started on core %d", core);
+  return true;
+}
+
+// Like startAcquisition(), but every scan starts on a hardware timer tick
+// (esp_timer) on a fixed grid of periodUs, for samples that line up across
+// scans. GPIO and ADC channels are read first in each scan; with
+// setAnalogContinuous() their reads are only microseconds apart.
+bool startSynchronizedAcquisition(uint32_t periodUs, int core = 0, size_t ringSize = 4096) {
+  if (!acquisition.startSynchronized(acquisitionScan, &config, config.scanSize(), ringSize,
+                                     periodUs, core)) {
+    LOG_ERROR("Failed to start synchronized acquisition");
+    return false;
+  }
+  LOG_INFO("Synchronized acquisition started on core %d every %lu us", core,
+           (unsigned long)periodUs);
+  return true;
+}
+
+void stopAcquisition() {
+  acquisition.stop();
+  LOG_INFO("Acquisition stopped");
+}
+
+// ========== BINARY SAMPLE LOG ==========
+
+// Start logging to LOG_DIR on the SD card (config.begin() must have succeeded)
+bool startLogging(uint32_t maxFileBytes = LOG_DEFAULT_MAX_FILE) {
+  sampleLogger.setBusArbiter(&spiBus);
+  if (!sampleLogger.begin(maxFileBytes)) {
+    LOG_ERROR("Failed to start sample log");
+    return false;
+  }
+  LOG_INFO("Logging to " LOG_DIR "/LOG%05lu.BIN", (unsigned long)sampleLogger.getFileIndex());
+  return true;
+}
+
+void stopLogging() {
+  sampleLogger.end();
+  LOG_INFO("Sample log closed");
+}
+
+// Queue every sample of a scan; returns how many were accepted
+size_t logScan(const ScanFrame& frame) {
+  size_t n = 0;
+  for (size_t i = 0; i < frame.count; i++) {
+    if (sampleLogger.append(frame.timestampUs[i], frame.channel[i], frame.status[i],
+                            frame.value[i], frame.sub[i])) {
+      n++;
+    }
+  }
+  return n;
+}
+
+// ========== SERIAL TELEMETRY ==========
+
+// TELEMETRY_TEXT: CSV lines, TELEMETRY_BINARY: COBS frames of scansPerFrame
+// scans (decode with tools/teledump), TELEMETRY_OFF: streamScan() does nothing
+void setTelemetryMode(TelemetryMode mode, uint8_t scansPerFrame = 1) {
+  telemetry.setMode(mode, scansPerFrame);
+  LOG_INFO("Telemetry: %s", mode == TELEMETRY_BINARY ? "binary" :
+                            mode == TELEMETRY_TEXT ? "text" : "off");
+}
+
+// Send a scan over Serial in the current telemetry mode
+void streamScan(const ScanFrame& frame) {
+  telemetry.send(frame);
+}
+
+// ========== SAMPLE HISTORY ==========
+
+// Keep the newest maxPoints / maxSeries points of each channel value in
+// PSRAM (4 MB by default). Query with history.latest(), range(),
+// aggregate() and downsample().
+bool startHistory(size_t maxPoints = 524288, uint16_t maxSeries = 64) {
+  if (!history.begin(maxPoints, maxSeries)) {
+    LOG_ERROR("Failed to allocate sample history");
+    return false;
+  }
+  LOG_INFO("History: %u points per channel value, %u KB",
+           (unsigned)history.capacityPerSeries(), (unsigned)(history.memoryBytes() / 1024));
+  return true;
+}
+
+// Add a scan's samples to the history; returns how many were stored
+size_t recordScan(const ScanFrame& frame) {
+  return history.record(frame);
+}
+
+// ========== READ STATISTICS ==========
+
+// Per-channel and per-bus read latency histograms, status counts, I2C
+// retries, scan time and bus utilization as one JSON line
+void printReadStats(Print& out = Serial) {
+  config.getReadStats().printJson(out);
+}
+
+void resetReadStats() {
+  config.getReadStats().reset();
+}
+
+// Instrumentation is on by default; off skips the cycle counter reads
+void setReadStatsEnabled(bool enabled) {
+  config.getReadStats().setEnabled(enabled);
+}
+
+// Read event for each channel type, indexed by ChannelType
+static const uint8_t READ_EVENTS[] = {
+  EV_CHANNEL_MISSING, EV_READ_DIGITAL, EV_READ_ANALOG, EV_READ_ONEWIRE, EV_READ_SPI, EV_READ_I2C,
+  EV_READ_COUNTER, EV_READ_FREQUENCY, EV_READ_DUTY
+};
+
+// Read sensor from any channel. The status tells a failed read apart
+// from a reading that happens to be -1 (SAMPLE_NO_DEVICE: no such channel).
+SampleStatus readChannel(int channel, float& value) {
+  value = 0;
+  ScanLock lock(config.getScanMutex());  // Keeps slot valid against a rebuild
+  const ChannelSlot* slot = config.findChannel(channel);
+  
+  if (!slot) {
+    LOG_EVENT_WARN(EV_CHANNEL_MISSING, channel, 0, 0);
+    return SAMPLE_NO_DEVICE;
+  }
+  
+  SampleStatus status = config.readTimed(channel, *slot, value);
+  config.noteSample();
+  
+  if (slot->type == CH_I2C) {
+    if (status == SAMPLE_SKIPPED) {
+      LOG_EVENT_WARN(EV_I2C_BACKOFF, channel, slot->address, 0);
+    } else if (status == SAMPLE_TIMEOUT) {
+      LOG_EVENT_WARN(EV_READ_TIMEOUT, channel, slot->address, 0);
+    } else if (status != SAMPLE_OK) {
+      LOG_EVENT_WARN(EV_I2C_ERROR, channel, slot->address, 0);
     } else {
-      Serial.printf("I2C error on Channel %d (0x%02X)\n", channel, address);
-      return -1;
+      LOG_EVENT_DEBUG(EV_READ_I2C, channel, slot->address, value);
     }
+    return status;
   }
   
-  return -1;
+  if (status == SAMPLE_OK) {
+    LOG_EVENT_DEBUG(READ_EVENTS[slot->type], channel, slot->pin, value);
+  } else if (status == SAMPLE_TIMEOUT) {
+    LOG_EVENT_WARN(EV_READ_TIMEOUT, channel, slot->pin, 0);
+  } else {
+    LOG_EVENT_WARN(status == SAMPLE_NOT_READY ? EV_NOT_READY : EV_NO_DEVICE, channel, slot->pin, 0);
+  }
+  return status;
+}
+
+// Read sensor from any channel, -1 if the read failed
+float readChannel(int channel) {
+  float value;
+  return readChannel(channel, value) == SAMPLE_OK ? value : -1;
 }
 
-void setup() {
-  // Your setup code here
+// Read one value of a multi-value I2C channel (sub 0 = readChannel()).
+// SAMPLE_NO_DEVICE also covers a sub the channel doesn't have.
+SampleStatus readSubChannel(int channel, uint8_t sub, float& value) {
+  float values[I2C_MAX_VALUES];
+  SampleStatus status;
+  uint8_t count = config.readChannelValues(channel, values, status);
+  config.noteSample();
+  value = 0;
+  
+  if (status == SAMPLE_OK && sub >= count) status = SAMPLE_NO_DEVICE;
+  if (status != SAMPLE_OK) {
+    LOG_EVENT_WARN(status == SAMPLE_SKIPPED ? EV_I2C_BACKOFF :
+                   status == SAMPLE_TIMEOUT ? EV_READ_TIMEOUT : EV_I2C_ERROR, channel, sub, 0);
+    return status;
+  }
+  
+  value = values[sub];
+  LOG_EVENT_DEBUG(EV_READ_I2C, channel, sub, value);
+  return status;
 }
 
-void loop() {
-  // Your loop code here
-}
\ No newline at end of file
+// Read one value of a multi-value I2C channel, -1 if the read failed
+float readSubChannel(int channel, uint8_t sub) {
+  float value;
+  return readSubChannel(channel, sub, value) == SAMPLE_OK ? value : -1;
+}
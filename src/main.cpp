@@ -12,6 +12,9 @@ void example_initialization() {
   Serial.begin(115200);
   delay(1000);
   
+  // Print deferred read/error events from a low-priority task
+  eventLog.startTask();
+  
   // Initialize the config system
   if (!config.begin()) {
     Serial.println("Failed to initialize!");
@@ -35,20 +38,40 @@ void example_loadConfig() {
 // ============================================================================
 // SECTION 3: CREATE DEFAULT FIXED CHANNELS
 // ============================================================================
+// A fixed channel with the default rate, SPI and filter settings
+FixedChannel fixedChannel(int channel, int pin, const char* mode, bool active, int sensor = 0) {
+  FixedChannel fc = FixedChannel();
+  fc.channel = channel;
+  fc.pin = pin;
+  fc.mode = mode;
+  fc.active = active;
+  fc.sensor = sensor;
+  return fc;
+}
+
 void example_createDefaultFixedChannels() {
   // Add fixed channels manually to the vector
-  // Format: {channel, pin, mode, active}
-  // Modes: "DIGITAL", "ANALOG", "ONEWIRE", "SPI"
-  
-  config.getFixedChannels().push_back({1, 2, "DIGITAL", true});   // Digital sensor on pin 2
-  config.getFixedChannels().push_back({2, 4, "ANALOG", true});    // Analog sensor on pin 4
-  config.getFixedChannels().push_back({3, 5, "ONEWIRE", true});   // DS18B20 on pin 5
-  config.getFixedChannels().push_back({4, 15, "DIGITAL", true});  // Digital sensor on pin 15
-  config.getFixedChannels().push_back({5, 14, "SPI", true});      // SPI sensor CS on pin 14
-  config.getFixedChannels().push_back({6, 27, "SPI", true});      // SPI sensor CS on pin 27
-  config.getFixedChannels().push_back({7, 34, "ANALOG", false});  // Analog (disabled)
+  // Format: fixedChannel(channel, pin, mode, active)
+  //     or: fixedChannel(channel, pin, "ONEWIRE", active, sensor_index) for several
+  //         DS18B20s on one pin
+  // Modes: "DIGITAL", "ANALOG", "ONEWIRE", "SPI", "COUNTER", "FREQUENCY", "DUTY"
   
+#if defined(BOARD_PROFILE)
+  // Built with a board profile: the fixed channels are already there
   config.saveConfig();
+  return;
+#endif
+  std::vector<FixedChannel>& fixed = config.getFixedChannels();
+  fixed.push_back(fixedChannel(1, 2, "DIGITAL", true));    // Digital sensor on pin 2
+  fixed.push_back(fixedChannel(2, 4, "ANALOG", true));     // Analog sensor on pin 4
+  fixed.push_back(fixedChannel(3, 5, "ONEWIRE", true));    // DS18B20 on pin 5
+  fixed.push_back(fixedChannel(4, 15, "DIGITAL", true));   // Digital sensor on pin 15
+  fixed.push_back(fixedChannel(5, 14, "SPI", true));       // SPI sensor CS on pin 14
+  fixed.push_back(fixedChannel(6, 27, "SPI", true));       // SPI sensor CS on pin 27
+  fixed.push_back(fixedChannel(7, 34, "ANALOG", false));   // Analog (disabled)
+  fixed.push_back(fixedChannel(8, 5, "ONEWIRE", true, 1)); // Second DS18B20 on pin 5
+  
+  config.markChanged();  // Rebuild the channel table and save
   Serial.println("Default fixed channels created");
 }
 
@@ -58,15 +81,17 @@ void example_createDefaultFixedChannels() {
 void example_addI2C() {
   // Add I2C sensor dynamically
   // Format: addI2C(channel_number, i2c_address)
+  //     or: addI2C(channel_number, i2c_address, register, byte_count)
+  //     or: addI2C(channel_number, i2c_address, -1, 0, "driver")
   // Channel must be > MAX_FIXED_CHANNELS (default: > 30)
   
   int id1 = addI2C(31, 0x3C);  // OLED at address 0x3C
   Serial.printf("I2C channel 31 added with ID: %d\n", id1);
   
-  int id2 = addI2C(32, 0x68);  // IMU at address 0x68
+  int id2 = addI2C(32, 0x68, -1, 0, "mpu6050");  // IMU: accel, gyro, temperature
   Serial.printf("I2C channel 32 added with ID: %d\n", id2);
   
-  addI2C(33, 0x76);  // Pressure sensor at address 0x76
+  addI2C(33, 0x76, -1, 0, "bmp280");  // Pressure sensor: temperature, pressure
   addI2C(34, 0x40);  // Another I2C sensor
 }
 
@@ -201,27 +226,15 @@ void example_saveConfig() {
 // SECTION 15: AUTO-SCAN I2C BUS
 // ============================================================================
 void example_scanI2C() {
-  // Automatically scan I2C bus and add all found devices
+  // Probe the whole bus (fast clock, short timeout) and sync the channel
+  // list: new devices are added, channels whose device is gone are
+  // deactivated, with one config write at the end
   
   Serial.println("Scanning I2C bus...");
   
-  int channelNum = MAX_FIXED_CHANNELS + 1;
-  int found = 0;
+  int changes = config.discoverI2C();
   
-  for (uint8_t address = 1; address < 127; address++) {
-    Wire.beginTransmission(address);
-    int error = Wire.endTransmission();
-    
-    if (error == 0) {
-      Serial.printf("Found I2C device at 0x%02X, adding as channel %d\n", 
-                    address, channelNum);
-      addI2C(channelNum, address);
-      channelNum++;
-      found++;
-    }
-  }
-  
-  Serial.printf("I2C scan complete: %d devices found\n", found);
+  Serial.printf("I2C scan complete: %d channels changed\n", changes);
 }
 
 // ============================================================================
@@ -492,6 +505,474 @@ void example_batchReadWithErrorHandling() {
   Serial.printf("Results: %d successful, %d errors\n", successCount, errorCount);
 }
 
+// ============================================================================
+// SECTION 31: SCAN ALL ACTIVE CHANNELS (BATCHED)
+// ============================================================================
+ScanFrame scanFrame;  // Caller-owned results, reused every scan
+
+void example_scanAll() {
+  // Read every active channel in one pass using the precomputed scan plan
+  // Format: config.scanAll(frame) - returns number of samples written
+  
+  // Only grows when the config gained channels; steady-state scans don't allocate
+  if (scanFrame.capacity() < config.scanSize()) {
+    scanFrame.reserve(config.scanSize());
+  }
+  
+  size_t n = config.scanAll(scanFrame);
+  
+  Serial.printf("Scanned %d channels:\n", (int)n);
+  for (size_t i = 0; i < n; i++) {
+    if (scanFrame.status[i] == SAMPLE_OK) {
+      Serial.printf("  Channel %d: %.2f @ %lu us\n", scanFrame.channel[i],
+                    scanFrame.value[i], (unsigned long)scanFrame.timestampUs[i]);
+    } else {
+      Serial.printf("  Channel %d: status %d\n", scanFrame.channel[i], scanFrame.status[i]);
+    }
+  }
+}
+
+// ============================================================================
+// SECTION 32: DUAL-CORE ACQUISITION
+// ============================================================================
+void example_startAcquisition() {
+  // Sample on core 0 while loop() (core 1) consumes
+  // Format: startAcquisition(period_ms, core, ring_size)
+  
+  startAcquisition(10, 0, 4096);  // Scan every 10 ms
+}
+
+void example_drainSamples() {
+  // Pull everything the acquisition task produced since the last call
+  
+  static Sample samples[256];
+  size_t n;
+  size_t total = 0;
+  while ((n = acquisition.drain(samples, 256)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      // Process samples[i].channel / .value / .timestampUs here
+    }
+    total += n;
+  }
+  
+  Serial.printf("Drained %d samples (%lu scans, %lu overruns, %lu underruns, %lu truncated)\n",
+                (int)total, (unsigned long)acquisition.scanCount(),
+                (unsigned long)acquisition.overrunCount(),
+                (unsigned long)acquisition.underrunCount(),
+                (unsigned long)config.getTruncatedValues());
+}
+
+// ============================================================================
+// SECTION 33: ONE-WIRE TEMPERATURE SENSORS
+// ============================================================================
+void example_oneWireSensors() {
+  // DS18B20s are discovered once per pin and converted together in the
+  // background; a read returns the latest finished conversion (no 750 ms wait)
+  // Format: config.setOneWireResolution(bits) - 9..12 bits, saved with config
+  
+  config.setOneWireResolution(11);  // 0.125 C steps, 375 ms conversions
+  
+  Serial.printf("DS18B20s on pin 5: %d\n", config.getOneWireDeviceCount(5));
+  float t = readChannel(3);  // First scan only starts the conversion
+  Serial.printf("Channel 3: %.2f C\n", t);
+}
+
+// ============================================================================
+// SECTION 34: I2C BUS CLOCK AND HEALTH
+// ============================================================================
+void example_i2cBusStats() {
+  // Format: config.setI2CClock(hz) - saved with config as "i2c_clock_hz"
+  config.setI2CClock(400000);  // Fast mode
+  
+  if (scanFrame.capacity() < config.scanSize()) {
+    scanFrame.reserve(config.scanSize());
+  }
+  config.scanAll(scanFrame);
+  Serial.printf("I2C bus time last scan: %lu us\n", (unsigned long)config.getI2CBusTimeUs());
+  
+  for (const auto& ch : config.getI2CChannels()) {
+    const I2CDeviceHealth& h = config.getI2CHealth(ch.address);
+    Serial.printf("  0x%02X: %lu ok, %lu errors, %d consecutive failures\n", ch.address,
+                  (unsigned long)h.okCount, (unsigned long)h.errorCount, h.failures);
+  }
+}
+
+// ============================================================================
+// SECTION 35: BINARY SAMPLE LOGGING
+// ============================================================================
+void example_startLogging() {
+  // Binary 512-byte blocks, written to SD in the background, new file every 16 MB
+  // Convert on a PC with tools/logdump: logdump LOG00001.BIN > samples.csv
+  
+  startLogging(16UL << 20);
+}
+
+void example_logSamples() {
+  // Log whatever the acquisition task produced (see SECTION 32)
+  static Sample samples[256];
+  size_t n;
+  while ((n = acquisition.drain(samples, 256)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      sampleLogger.append(samples[i]);
+    }
+  }
+  
+  // Bound data lost on power failure to about one second
+  static uint32_t lastSync = 0;
+  if (millis() - lastSync >= 1000) {
+    sampleLogger.sync();
+    lastSync = millis();
+  }
+  
+  if (sampleLogger.droppedCount() > 0) {
+    Serial.printf("Log dropped %lu samples\n", (unsigned long)sampleLogger.droppedCount());
+  }
+}
+
+// ============================================================================
+// SECTION 36: BATCH CONFIG CHANGES
+// ============================================================================
+void example_batchChanges() {
+  // Each channel API call normally rewrites config.json. Inside a batch the
+  // tables update immediately but the SD write happens once, at commit()
+  // Format: config.beginBatch(); ...changes...; config.commit();
+  
+  config.beginBatch();
+  addI2C(40, 0x48);
+  addI2C(41, 0x49);
+  disableChannel(7);
+  updateChannel(2, "ANALOG");
+  if (config.commit()) {
+    Serial.println("4 changes saved with one write");
+  }
+}
+
+// ============================================================================
+// SECTION 37: BOOT TIME (BINARY CONFIG SNAPSHOT)
+// ============================================================================
+void example_bootTime() {
+  // saveConfig() also writes /config.bin; loadConfig() uses it while it
+  // matches config.json and parses the JSON only when it doesn't
+  // Format: config.loadConfig(use_snapshot)
+  
+  const char* paths[] = {"JSON", "snapshot"};
+  for (int useSnapshot = 0; useSnapshot <= 1; useSnapshot++) {
+    config.loadConfig(useSnapshot);
+    readChannel(1);  // First sample
+    
+    const BootStats& stats = config.getBootStats();
+    Serial.printf("%s: config load %lu us, time to first sample %lu us%s\n",
+                  paths[useSnapshot], (unsigned long)stats.configLoadUs,
+                  (unsigned long)stats.firstSampleUs,
+                  useSnapshot && !stats.fromSnapshot ? " (snapshot stale, used JSON)" : "");
+  }
+}
+
+// ============================================================================
+// SECTION 38: LOGGING
+// ============================================================================
+void example_logging() {
+  // Build with -DLOG_LEVEL=LOG_LEVEL_INFO to compile out per-read messages,
+  // or LOG_LEVEL_NONE for no logging code at all
+  // Format: LOG_INFO("fmt", ...) prints now; LOG_EVENT_DEBUG(...) is queued
+  
+  LOG_INFO("Active channels: %d", config.getActiveChannelCount());
+  
+  Serial.printf("Log events pending: %d, dropped: %lu\n", (int)eventLog.pending(),
+                (unsigned long)eventLog.droppedCount());
+}
+
+// ============================================================================
+// SECTION 39: I2C HOT-PLUG DETECTION
+// ============================================================================
+void example_startI2CHotPlug() {
+  // Every scanAll() probes a few more addresses; a full pass over the bus
+  // takes (112 / rate) scans. Unplugged devices must miss two passes.
+  // Format: config.setI2CDiscoveryRate(addresses_per_scan)
+  
+  config.setI2CDiscoveryRate(4);
+}
+
+void example_applyI2CHotPlug() {
+  // Call from loop(): applies what background discovery found
+  if (config.i2cChangesPending()) {
+    int changes = config.syncI2CChannels();
+    if (changes > 0) {
+      Serial.printf("I2C hot-plug: %d channels changed\n", changes);
+    }
+  }
+}
+
+// ============================================================================
+// SECTION 40: PER-CHANNEL SAMPLE RATES
+// ============================================================================
+void example_startScheduledAcquisition() {
+  // Each channel keeps its own period; the acquisition task sleeps until the
+  // next deadline and reads only the channels that are due
+  // Format: setSampleRate(channel, hz) - 0 = default period (1 s)
+  
+  config.beginBatch();
+  setSampleRate(2, 1000);  // Analog at 1 kHz
+  setSampleRate(3, 1);     // DS18B20 once a second
+  setSampleRate(1, 50);    // Digital at 50 Hz
+  config.commit();
+  
+  startScheduledAcquisition();
+}
+
+void example_channelTiming() {
+  // How well each channel keeps its rate
+  for (int ch : {1, 2, 3}) {
+    const ChannelTiming* t = config.getChannelTiming(ch);
+    if (!t) continue;
+    
+    unsigned long meanUs = t->samples ? (unsigned long)(t->jitterSumUs / t->samples) : 0;
+    Serial.printf("Channel %d: period %lu us, %lu samples, %lu missed, jitter mean %lu / max %lu us\n",
+                  ch, (unsigned long)t->periodUs, (unsigned long)t->samples,
+                  (unsigned long)t->missed, meanUs, (unsigned long)t->maxJitterUs);
+  }
+}
+
+// ============================================================================
+// SECTION 41: CONTINUOUS ANALOG SAMPLING
+// ============================================================================
+void example_analogContinuous() {
+  // ADC1 pins (GPIO1-10) of active ANALOG channels are converted continuously
+  // by DMA; reads return the latest averaged value in mV without waiting
+  // Format: config.setAnalogContinuous(hz_per_pin, oversample, smoothing)
+  
+  config.setAnalogContinuous(20000, 32, 2);  // 625 values/s per pin, light smoothing
+  
+  delay(10);  // First values after one oversample block
+  Serial.printf("Channel 2: %.0f mV (%lu conversions so far)\n", readChannel(2),
+                (unsigned long)config.getAdcConversionCount());
+  
+  // config.setAnalogContinuous(0);  // Back to one analogRead() per read
+}
+
+// ============================================================================
+// SECTION 42: EDGE COUNTING, FREQUENCY AND DUTY CYCLE
+// ============================================================================
+void example_edgeChannels() {
+  // COUNTER / FREQUENCY / DUTY pins are counted by interrupt, so pulses
+  // between scans are never lost. Channels on the same pin share a counter.
+  // Format: updateChannel(channel, "COUNTER" | "FREQUENCY" | "DUTY")
+  
+  config.beginBatch();
+  updateChannel(6, "COUNTER");    // Flow meter pulses
+  updateChannel(7, "FREQUENCY");  // Fan tachometer
+  config.commit();
+  
+  Serial.printf("Pulses: %.0f, fan: %.1f Hz\n", readChannel(6), readChannel(7));
+  config.resetEdgeCount(6);  // Start a new totalizer period
+}
+
+// ============================================================================
+// SECTION 43: SPI SENSOR SETTINGS
+// ============================================================================
+void example_spiSettings() {
+  // Each SPI channel has its own clock, mode, command byte and response
+  // length; the scan reads all SPI channels in one hold of the bus, which
+  // it shares with SD logging
+  // Format: setSpiChannel(channel, clock_hz, mode, command, response_bytes)
+  
+  setSpiChannel(5, 5000000, 0, 0x00, 2);  // MAX31855-style: no command, 2 bytes
+  
+  Serial.printf("Channel 5: 0x%04lX\n", (unsigned long)readChannel(5));
+  Serial.printf("SPI bus: %lu waits, max %lu us, %lu scans skipped SPI\n",
+                (unsigned long)spiBus.contendedCount(), (unsigned long)spiBus.getMaxWaitUs(),
+                (unsigned long)config.getSpiSkippedBatches());
+}
+
+// ============================================================================
+// SECTION 44: I2C SENSOR DRIVERS
+// ============================================================================
+void example_i2cDrivers() {
+  // A driver configures the sensor on first use and reads all of its
+  // registers in one burst; each decoded value is a sub-channel (frame.sub,
+  // the "sub" column of logdump). Built in: "raw", "raw16", "mpu6050", "bmp280"
+  // Format: setI2CDriver(channel, "driver"), JSON: "driver": "bmp280"
+  
+  setI2CDriver(33, "bmp280");
+  
+  Serial.printf("BMP280: %.2f C, %.2f hPa\n", readSubChannel(33, 0), readSubChannel(33, 1));
+  
+  float imu[I2C_MAX_VALUES];
+  SampleStatus status;
+  uint8_t n = config.readChannelValues(32, imu, status);  // One bus transaction
+  if (status == SAMPLE_OK && n == 7) {
+    Serial.printf("Accel %.2f %.2f %.2f g, gyro %.1f %.1f %.1f dps, %.1f C\n",
+                  imu[0], imu[1], imu[2], imu[3], imu[4], imu[5], imu[6]);
+  }
+}
+
+// ============================================================================
+// SECTION 45: WINDOW STATISTICS, DECIMATION AND DEADBAND
+// ============================================================================
+void example_channelFilters() {
+  // An output stage after the scan: every sample updates the channel's
+  // window statistics, then decimation and the deadband decide what goes
+  // on to the ring buffer and log. Status changes always get through.
+  // Format: setChannelFilter(channel, decimate, deadband, stats_window, report_interval_ms)
+  // JSON: "decimate", "deadband", "stats_window", "report_interval_ms"
+  
+  setChannelFilter(3, 0, 0.25f, 60, 60000);  // Temperature: changes of 0.25 C, at least once a minute
+  setChannelFilter(2, 10, 0, 100);           // Analog: every 10th sample, stats over 100
+  
+  if (scanFrame.capacity() < config.scanSize()) {
+    scanFrame.reserve(config.scanSize());
+  }
+  config.scanAll(scanFrame);
+  size_t kept = config.filterScan(scanFrame);  // startAcquisition() applies it itself
+  Serial.printf("%d samples after filtering\n", (int)kept);
+  
+  const ChannelFilter* f = config.getChannelFilter(2);
+  if (f && f->lastWindow().count > 0) {
+    const WindowSummary& w = f->lastWindow();
+    Serial.printf("Channel 2: mean %.1f, sd %.2f, range %.0f..%.0f over %lu samples\n",
+                  w.mean, sqrtf(w.variance), w.min, w.max, (unsigned long)w.count);
+  }
+  if (f) {
+    Serial.printf("Channel 2: passed %lu of %lu\n", (unsigned long)f->passedCount(),
+                  (unsigned long)f->seenCount());
+  }
+}
+
+// ============================================================================
+// SECTION 46: BINARY TELEMETRY OVER USB
+// ============================================================================
+void example_startBinaryTelemetry() {
+  // Scans go out as CRC-checked COBS frames of a few bytes per sample
+  // instead of printf text; decode on the PC with tools/teledump.
+  // Log text in between is skipped by the decoder.
+  // Format: setTelemetryMode(TELEMETRY_OFF | TELEMETRY_TEXT | TELEMETRY_BINARY, scans_per_frame)
+  
+  setTelemetryMode(TELEMETRY_BINARY, 4);  // Four scans per frame
+}
+
+void example_streamScans() {
+  if (scanFrame.capacity() < config.scanSize()) {
+    scanFrame.reserve(config.scanSize());
+  }
+  config.scanAll(scanFrame);
+  config.filterScan(scanFrame);
+  streamScan(scanFrame);
+}
+
+// ============================================================================
+// SECTION 47: SAMPLE HISTORY IN PSRAM
+// ============================================================================
+void example_history() {
+  // Keep recent values per channel and query them later
+  // Format: startHistory(total_points, max_channel_values)
+  
+  if (!history.isStarted() && !startHistory(524288, 64)) return;
+  
+  if (scanFrame.capacity() < config.scanSize()) {
+    scanFrame.reserve(config.scanSize());
+  }
+  config.scanAll(scanFrame);
+  recordScan(scanFrame);
+  
+  HistoryPoint last[5];
+  size_t n = history.latest(1, 0, last, 5);  // Newest 5 of channel 1
+  for (size_t i = 0; i < n; i++) {
+    Serial.printf("  %llu us: %.3f\n", (unsigned long long)last[i].timeUs, last[i].value);
+  }
+  
+  // Min/max/mean of channel 4 over the last minute
+  uint64_t now = history.timeOf(micros());
+  HistoryAggregate a = history.aggregate(4, 0, now - 60000000ULL, now);
+  Serial.printf("Channel 4, last 60 s: %lu samples, min %.2f max %.2f mean %.3f\n",
+                (unsigned long)a.count, a.min, a.max, a.mean);
+  
+  // Whole history of the BMP280 pressure (channel 33, value 1) reduced to 200 points for a chart
+  static HistoryPoint chart[200];
+  n = history.downsample(33, 1, 0, UINT64_MAX, chart, 200);
+  Serial.printf("Channel 33.1: %u chart points\n", (unsigned)n);
+}
+
+// ============================================================================
+// SECTION 48: READ STATUS AND READ STATISTICS
+// ============================================================================
+void example_readStats() {
+  // A status instead of -1, so a failed read can't pass for a value
+  float value;
+  SampleStatus status = readChannel(3, value);
+  if (status == SAMPLE_OK) {
+    Serial.printf("Channel 3: %.2f\n", value);
+  } else {
+    Serial.printf("Channel 3: %s\n", statusName(status));  // e.g. "timeout", "no_device"
+  }
+  
+  // Every read is timed: latency histograms per channel and bus, status
+  // and retry counts, scan time and bus utilization, as one JSON line
+  printReadStats();
+  resetReadStats();  // Start a new measurement period
+}
+
+// ============================================================================
+// SECTION 49: SYNCHRONIZED SCANS ON A HARDWARE TIMER
+// ============================================================================
+void example_synchronizedScans() {
+  // Scans start on a fixed 1 ms grid from esp_timer instead of delay(),
+  // so the period never drifts and every sample carries its read time.
+  // Continuous ADC keeps analog reads within microseconds of the digital
+  // snapshot for correlating the two.
+  // Format: startSynchronizedAcquisition(period_us)
+  
+  config.setAnalogContinuous(20000, 8);
+  if (!startSynchronizedAcquisition(1000)) return;
+  
+  Sample samples[64];
+  uint32_t start = millis();
+  size_t total = 0;
+  while (millis() - start < 2000) {
+    total += acquisition.drain(samples, 64);
+    delay(10);
+  }
+  stopAcquisition();
+  
+  const TickStats& t = acquisition.getTickStats();
+  Serial.printf("%u samples, %lu scans, %lu missed ticks\n", (unsigned)total,
+                (unsigned long)t.ticks, (unsigned long)t.missed);
+  Serial.printf("Tick latency min %lu / mean %lu / max %lu us\n", (unsigned long)t.minLatencyUs,
+                (unsigned long)(t.ticks ? t.latencySumUs / t.ticks : 0),
+                (unsigned long)t.maxLatencyUs);
+  Serial.printf("Scan skew max %lu us, digital/analog skew max %lu us\n",
+                (unsigned long)t.maxSkewUs, (unsigned long)t.maxAlignedSkewUs);
+}
+
+// ============================================================================
+// SECTION 50: COMPILE-TIME BOARD PROFILE
+// ============================================================================
+void example_boardProfile() {
+  // Build with -DBOARD_PROFILE=DevKitProfile (see BoardProfile.h) to compile
+  // the fixed channel layout in. scanAll() then reads fixed channels with
+  // generated code; changing a fixed channel at runtime falls back to the
+  // channel table until the layout matches the profile again.
+#if defined(BOARD_PROFILE)
+  static ScanFrame frame;
+  frame.reserve(config.scanSize());
+  
+  uint32_t profileUs = micros();
+  config.scanAll(frame);
+  profileUs = micros() - profileUs;
+  
+  config.useBoardProfile(false);
+  uint32_t tableUs = micros();
+  config.scanAll(frame);
+  tableUs = micros() - tableUs;
+  config.useBoardProfile(true);
+  
+  Serial.printf("Board profile %s, scan %lu us (channel table: %lu us)\n",
+                config.boardProfileActive() ? "active" : "inactive (layout changed)",
+                (unsigned long)profileUs, (unsigned long)tableUs);
+#else
+  Serial.println("Built without a board profile");
+#endif
+}
+
 // ============================================================================
 // MAIN SETUP - DEMONSTRATES TYPICAL WORKFLOW
 // ============================================================================
@@ -513,10 +994,12 @@ void setup() {
   Serial.println("\n>>> Adding I2C sensors...");
   example_addI2C();
   
-  // Step 5: Update some channels
+  // Step 5: Update some channels (one config write for all of them)
   Serial.println("\n>>> Updating channels...");
+  config.beginBatch();
   example_updateChannelMode();
   example_disableChannel();
+  config.commit();
   
   // Step 6: Save changes
   example_saveConfig();
@@ -527,6 +1010,7 @@ void setup() {
   example_getActiveCount();
   example_getActiveList();
   example_countChannelsByMode();
+  example_bootTime();
   
   Serial.println("\n=== Setup Complete ===\n");
 }
@@ -539,8 +1023,11 @@ void loop() {
   Serial.println("Reading all active sensors...");
   Serial.println("========================================");
   
-  // Option 1: Simple read all active
-  example_readAllActive();
+  // Option 1: Batched scan of all active channels
+  example_scanAll();
+  
+  // Option 1b: Read all active one channel at a time (uncomment to use)
+  // example_readAllActive();
   
   // Option 2: Read by type (uncomment to use)
   // example_readFixedChannels();
@@ -554,6 +1041,35 @@ void loop() {
   // Option 4: Batch read with error handling (uncomment to use)
   // example_batchReadWithErrorHandling();
   
+  // Option 5: Dual-core acquisition (call example_startAcquisition() in setup)
+  // example_drainSamples();
+  
+  // Option 6: Acquisition straight to the SD log (call example_startAcquisition()
+  // and example_startLogging() in setup)
+  // example_logSamples();
+  
+  // Option 7: Pick up hot-plugged I2C sensors (call example_startI2CHotPlug() in setup)
+  // example_applyI2CHotPlug();
+  
+  // Option 8: Per-channel rates (call example_startScheduledAcquisition() in setup)
+  // example_drainSamples();
+  // example_channelTiming();
+  
+  // Option 9: Binary stream to the PC (call example_startBinaryTelemetry() in setup)
+  // example_streamScans();
+  
+  // Option 10: Record into the PSRAM history and query it
+  // example_history();
+  
+  // Option 11: Read latency and error statistics
+  // example_readStats();
+  
+  // Option 12: Timer-driven scans with jitter statistics
+  // example_synchronizedScans();
+  
+  // Option 13: Scan cost with the compiled-in board profile
+  // example_boardProfile();
+  
   Serial.println("========================================\n");
   
   delay(5000);  // Read every 5 seconds
@@ -0,0 +1,43 @@
+/*
+ * Host tool: decode a binary telemetry stream (TelemetryFormat.h) to CSV
+ * Reads a capture file or stdin, e.g. straight from the board's USB port.
+ *
+ * Build: g++ -O2 -std=c++17 -Iinclude tools/teledump.cpp -o teledump
+ * Usage: teledump capture.bin > samples.csv
+ *        stty -F /dev/ttyACM0 raw && teledump < /dev/ttyACM0 > samples.csv
+ */
+
+#include <stdio.h>
+#include "TelemetryFormat.h"
+
+static void printSample(const TelemetrySample& s, void* context) {
+  (void)context;
+  printf("%u,%d,%u,%u,%.9g\n", s.timestampUs, s.channel, s.sub, s.status, s.value);
+}
+
+int main(int argc, char** argv) {
+  if (argc > 2) {
+    fprintf(stderr, "usage: %s [CAPTURE] > out.csv\n", argv[0]);
+    return 2;
+  }
+  FILE* in = argc == 2 ? fopen(argv[1], "rb") : stdin;
+  if (!in) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  static TelemetryDecoder decoder;
+  uint8_t buf[4096];
+  size_t n;
+  printf("timestamp_us,channel,sub,status,value\n");
+  while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+    decoder.feed(buf, n, printSample, nullptr);
+    fflush(stdout);  // Live captures: show samples as frames arrive
+  }
+  if (in != stdin) fclose(in);
+
+  const TelemetryDecodeStats& s = decoder.getStats();
+  fprintf(stderr, "%u samples, %u frames, %u bad frames, %u sequence gaps, %llu bytes\n",
+          s.samples, s.frames, s.badFrames, s.sequenceGaps, (unsigned long long)s.bytes);
+  return 0;
+}